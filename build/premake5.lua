@@ -7,6 +7,9 @@ local internallibdir = "../src"
 -- local debug = "On"
 local debug = "Off"
 
+-- frame profiler (see src/core/Profiler.hpp): "Off", "On" or "Widgets"
+local profile = "Off"
+
 workspace( "drui" )
   location( "." )
   configurations( { "auto" } )
@@ -14,6 +17,12 @@ workspace( "drui" )
   architecture( "x86_64" )
   targetdir( "bin" )
   includedirs( { "../src", libincludedir } )
+  if profile ~= "Off" then
+    defines( { "DRUI_PROFILE" } )
+  end
+  if profile == "Widgets" then
+    defines( { "DRUI_PROFILE_WIDGETS" } )
+  end
   libdirs({
     liblinkdir .. "SDL2",
     internallibdir .. "Layout",
@@ -50,3 +59,14 @@ workspace( "drui" )
     files( { "../src/core/**.cpp", "../src/user/**.cpp" } )
     links( { "SDL2", "SDL2_image", "SDL2_ttf", "SDL2_gfx", "Layout", "SDL_FontCache" } )
 
+
+  project( "bench" )
+    location( "bench" )
+    kind( "ConsoleApp" )
+    language( "C++" )
+    cppdialect( "C++20" )
+    targetname( "bench" )
+    symbols( debug )
+    files( { "../src/bench/**.cpp", "../src/core/**.cpp", "../src/user/**.cpp" } )
+    removefiles( { "../src/core/main.cpp" } )
+    links( { "SDL2", "SDL2_image", "SDL2_ttf", "SDL2_gfx", "Layout", "SDL_FontCache" } )
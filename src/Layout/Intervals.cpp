@@ -76,7 +76,7 @@ namespace Intervals
     m_Position = position;
   }
 
-  void IntervalBuilder::ForEachChild( std::function< void( IntervalBuilder& child ) > f )
+  void IntervalBuilder::ForEachChild( FunctionRef< void( IntervalBuilder& child ) > f )
   {
     for( auto& child : m_Children )
     {
@@ -84,7 +84,7 @@ namespace Intervals
     }
   }
 
-  void IntervalBuilder::ForEachChild( std::function< void( IntervalBuilder const& child ) > f ) const
+  void IntervalBuilder::ForEachChild( FunctionRef< void( IntervalBuilder const& child ) > f ) const
   {
     for( auto const& child : m_Children )
     {
@@ -430,7 +430,7 @@ namespace Intervals
     return max;
   }
 
-  DeduceExtentMethod DeduceExtentWithInset( DeduceExtentMethod deduceExtent, int before, int after )
+  DeduceExtentMethod DeduceExtentWithInset( int ( *deduceExtent )( IntervalBuilder& ), int before, int after )
   {
     return [=] ( IntervalBuilder& parent )
     {
@@ -5,7 +5,8 @@
 
 #include<variant>
 #include<vector>
-#include<functional>
+
+#include<core/InplaceFunction.hpp>
 
 namespace Intervals
 {
@@ -59,10 +60,10 @@ namespace Intervals
   }
 
   class IntervalBuilder;
-  using DimChildrenMethod  = std::function< void( IntervalBuilder& ) >;
-  using PosChildrenMethod  = std::function< void( IntervalBuilder& ) >;
-  using DeduceExtentMethod = std::function< int ( IntervalBuilder& ) >;
-  using ExtentNotifier     = std::function< void( int extent ) >;
+  using DimChildrenMethod  = InplaceFunction< void( IntervalBuilder& ) >;
+  using PosChildrenMethod  = InplaceFunction< void( IntervalBuilder& ) >;
+  using DeduceExtentMethod = InplaceFunction< int ( IntervalBuilder& ) >;
+  using ExtentNotifier     = InplaceFunction< void( int extent ) >;
 
   struct Notifiers
   {
@@ -128,8 +129,8 @@ namespace Intervals
     int TotalRequestedByChildren() const;
     int CountFlexibleChildren() const;
 
-    void ForEachChild( std::function< void( IntervalBuilder& child ) > f );
-    void ForEachChild( std::function< void( IntervalBuilder const& child ) > f ) const;
+    void ForEachChild( FunctionRef< void( IntervalBuilder& child ) > f );
+    void ForEachChild( FunctionRef< void( IntervalBuilder const& child ) > f ) const;
 
     void AddChild( IntervalBuilder child );
     IntervalBuilder WithoutChildren() const;
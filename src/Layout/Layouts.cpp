@@ -38,8 +38,18 @@ namespace Layouts
   }
 
   void LayoutBuilder::DimChildren()
+  {
+    DimWidths();
+    DimHeights();
+  }
+
+  void LayoutBuilder::DimWidths()
   {
     m_WidthBuilder.DimChildren();
+  }
+
+  void LayoutBuilder::DimHeights()
+  {
     m_HeightBuilder.DimChildren();
   }
 
@@ -45,6 +45,8 @@ namespace Layouts
     void AddChild( LayoutBuilder child );
 
     void DimChildren();
+    void DimWidths();
+    void DimHeights();
     void PosChildren( int x, int y );
 
     Rect GetRect( int x_adjust = 0, int y_adjust = 0 ) const;
@@ -274,6 +274,7 @@ FC_GlyphData FC_MakeGlyphData(int cache_level, Sint16 x, Sint16 y, Uint16 w, Uin
     gd.rect.w = w;
     gd.rect.h = h;
     gd.cache_level = cache_level;
+    gd.last_used = 0;
 
     return gd;
 }
@@ -449,13 +450,20 @@ struct FC_Font
     int glyph_cache_size;
     int glyph_cache_count;
     FC_Image** glyph_cache;
+    Uint32* glyph_cache_last_used;  // frame stamps, parallel to glyph_cache
 
     char* loading_string;
 
+    // Atlas budget (not reset by FC_ClearFont())
+    Uint32 frame;
+    Uint32 atlas_budget;
+    FC_AtlasStats atlas_stats;
+
 };
 
 // Private
 static FC_GlyphData* FC_PackGlyphData(FC_Font* font, Uint32 codepoint, Uint16 width, Uint16 maxWidth, Uint16 maxHeight);
+static Uint8 FC_MakeRoomInGlyphCache(FC_Font* font);
 
 
 static FC_Rect FC_RenderLeft(FC_Font* font, FC_Target* dest, float x, float y, FC_Scale scale, const char* text);
@@ -896,6 +904,7 @@ static void FC_Init(FC_Font* font)
 
 
     font->glyph_cache = (FC_Image**)malloc(font->glyph_cache_size * sizeof(FC_Image*));
+    font->glyph_cache_last_used = (Uint32*)malloc(font->glyph_cache_size * sizeof(Uint32));
 
 	if (font->loading_string == NULL)
 		font->loading_string = FC_GetStringASCII();
@@ -904,6 +913,51 @@ static void FC_Init(FC_Font* font)
         fc_buffer = (char*)malloc(fc_buffer_size);
 }
 
+// Clears the given cache level texture to transparent
+static void FC_ClearGlyphCacheLevel(FC_Font* font, FC_Image* level)
+{
+#ifdef FC_USE_SDL_GPU
+    GPU_Target* target = GPU_LoadTarget(level);
+    if(target == NULL)
+        return;
+    GPU_Clear(target);
+    GPU_FreeTarget(target);
+#else
+    Uint8 r, g, b, a;
+    SDL_Texture* prev_target = SDL_GetRenderTarget(font->renderer);
+    SDL_Rect prev_clip, prev_viewport;
+    int prev_logicalw, prev_logicalh;
+    Uint8 prev_clip_enabled;
+    float prev_scalex, prev_scaley;
+    // only backup if previous target existed (SDL will preserve them for the default target)
+    if (prev_target) {
+        prev_clip_enabled = has_clip(font->renderer);
+        if (prev_clip_enabled)
+            prev_clip = get_clip(font->renderer);
+        SDL_RenderGetViewport(font->renderer, &prev_viewport);
+        SDL_RenderGetScale(font->renderer, &prev_scalex, &prev_scaley);
+        SDL_RenderGetLogicalSize(font->renderer, &prev_logicalw, &prev_logicalh);
+    }
+    SDL_SetTextureBlendMode(level, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(font->renderer, level);
+    SDL_GetRenderDrawColor(font->renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(font->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(font->renderer);
+    SDL_SetRenderDrawColor(font->renderer, r, g, b, a);
+    SDL_SetRenderTarget(font->renderer, prev_target);
+    if (prev_target) {
+        if (prev_clip_enabled)
+            set_clip(font->renderer, &prev_clip);
+        if (prev_logicalw && prev_logicalh)
+            SDL_RenderSetLogicalSize(font->renderer, prev_logicalw, prev_logicalh);
+        else {
+            SDL_RenderSetViewport(font->renderer, &prev_viewport);
+            SDL_RenderSetScale(font->renderer, prev_scalex, prev_scaley);
+        }
+    }
+#endif
+}
+
 static Uint8 FC_GrowGlyphCache(FC_Font* font)
 {
     if(font == NULL)
@@ -928,42 +982,7 @@ static Uint8 FC_GrowGlyphCache(FC_Font* font)
     //      , most functions use set_color_for_all_caches()
     //   - for evading this bug, you must use FC_SetDefaultColor(), before using any draw functions
     set_color(new_level, font->default_color.r, font->default_color.g, font->default_color.b, FC_GET_ALPHA(font->default_color));
-#ifndef FC_USE_SDL_GPU
-    {
-        Uint8 r, g, b, a;
-        SDL_Texture* prev_target = SDL_GetRenderTarget(font->renderer);
-        SDL_Rect prev_clip, prev_viewport;
-        int prev_logicalw, prev_logicalh;
-        Uint8 prev_clip_enabled;
-        float prev_scalex, prev_scaley;
-        // only backup if previous target existed (SDL will preserve them for the default target)
-        if (prev_target) {
-            prev_clip_enabled = has_clip(font->renderer);
-            if (prev_clip_enabled)
-                prev_clip = get_clip(font->renderer);
-            SDL_RenderGetViewport(font->renderer, &prev_viewport);
-            SDL_RenderGetScale(font->renderer, &prev_scalex, &prev_scaley);
-            SDL_RenderGetLogicalSize(font->renderer, &prev_logicalw, &prev_logicalh);
-        }
-        SDL_SetTextureBlendMode(new_level, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderTarget(font->renderer, new_level);
-        SDL_GetRenderDrawColor(font->renderer, &r, &g, &b, &a);
-        SDL_SetRenderDrawColor(font->renderer, 0, 0, 0, 0);
-        SDL_RenderClear(font->renderer);
-        SDL_SetRenderDrawColor(font->renderer, r, g, b, a);
-        SDL_SetRenderTarget(font->renderer, prev_target);
-        if (prev_target) {
-            if (prev_clip_enabled)
-                set_clip(font->renderer, &prev_clip);
-            if (prev_logicalw && prev_logicalh)
-                SDL_RenderSetLogicalSize(font->renderer, prev_logicalw, prev_logicalh);
-            else {
-                SDL_RenderSetViewport(font->renderer, &prev_viewport);
-                SDL_RenderSetScale(font->renderer, prev_scalex, prev_scaley);
-            }
-        }
-    }
-#endif
+    FC_ClearGlyphCacheLevel(font, new_level);
     return 1;
 }
 
@@ -1102,7 +1121,17 @@ static FC_GlyphData* FC_PackGlyphData(FC_Font* font, Uint32 codepoint, Uint16 wi
     last_glyph->rect.x += last_glyph->rect.w + 1 + FC_CACHE_PADDING;
     last_glyph->rect.w = width;
 
-    return FC_MapInsert(glyphs, codepoint, FC_MakeGlyphData(last_glyph->cache_level, last_glyph->rect.x, last_glyph->rect.y, last_glyph->rect.w, last_glyph->rect.h));
+    {
+        FC_GlyphData packed = FC_MakeGlyphData(last_glyph->cache_level, last_glyph->rect.x, last_glyph->rect.y, last_glyph->rect.w, last_glyph->rect.h);
+        FC_GlyphData* evicted = FC_MapFind(glyphs, codepoint);
+        if(evicted != NULL && evicted->cache_level == FC_GLYPH_EVICTED)
+        {
+            // Repacking a glyph whose cache level was recycled
+            *evicted = packed;
+            return evicted;
+        }
+        return FC_MapInsert(glyphs, codepoint, packed);
+    }
 }
 
 
@@ -1133,18 +1162,26 @@ Uint8 FC_SetGlyphCacheLevel(FC_Font* font, int cache_level, FC_Image* cache_text
             // Copy old cache to new one
             int i;
             FC_Image** new_cache;
+            Uint32* new_last_used;
             new_cache = (FC_Image**)malloc(font->glyph_cache_count * sizeof(FC_Image*));
+            new_last_used = (Uint32*)malloc(font->glyph_cache_count * sizeof(Uint32));
             for(i = 0; i < font->glyph_cache_size; ++i)
+            {
                 new_cache[i] = font->glyph_cache[i];
+                new_last_used[i] = font->glyph_cache_last_used[i];
+            }
 
             // Save new cache
             free(font->glyph_cache);
+            free(font->glyph_cache_last_used);
             font->glyph_cache_size = font->glyph_cache_count;
             font->glyph_cache = new_cache;
+            font->glyph_cache_last_used = new_last_used;
         }
     }
 
     font->glyph_cache[cache_level] = cache_texture;
+    font->glyph_cache_last_used[cache_level] = font->frame;
     return 1;
 }
 
@@ -1432,6 +1469,8 @@ void FC_ClearFont(FC_Font* font)
     }
     free(font->glyph_cache);
     font->glyph_cache = NULL;
+    free(font->glyph_cache_last_used);
+    font->glyph_cache_last_used = NULL;
 
     // Reset font
     FC_Init(font);
@@ -1461,6 +1500,7 @@ void FC_FreeFont(FC_Font* font)
         #endif
     }
     free(font->glyph_cache);
+    free(font->glyph_cache_last_used);
 
     free(font->loading_string);
 
@@ -1605,8 +1645,9 @@ void FC_GetCodepoints(FC_Font* font, Uint32* result)
 Uint8 FC_GetGlyphData(FC_Font* font, FC_GlyphData* result, Uint32 codepoint)
 {
     FC_GlyphData* e = FC_MapFind(font->glyphs, codepoint);
-    if(e == NULL)
+    if(e == NULL || e->cache_level == FC_GLYPH_EVICTED)
     {
+        Uint8 was_evicted = (e != NULL);
         char buff[5];
         int w, h;
         SDL_Color white = {255, 255, 255, 255};
@@ -1641,8 +1682,8 @@ Uint8 FC_GetGlyphData(FC_Font* font, FC_GlyphData* result, Uint32 codepoint)
         e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
         if(e == NULL)
         {
-            // Grow the cache
-            FC_GrowGlyphCache(font);
+            // Grow the cache, or recycle a level if that would exceed the atlas budget
+            FC_MakeRoomInGlyphCache(font);
 
             // Try packing again
             e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
@@ -1657,8 +1698,16 @@ Uint8 FC_GetGlyphData(FC_Font* font, FC_GlyphData* result, Uint32 codepoint)
         FC_AddGlyphToCache(font, surf);
 
         SDL_FreeSurface(surf);
+
+        font->atlas_stats.rasterizations++;
+        if(was_evicted)
+            font->atlas_stats.rerasterizations++;
     }
 
+    // Stamp for the atlas LRU
+    e->last_used = font->frame;
+    font->glyph_cache_last_used[e->cache_level] = font->frame;
+
     if(result != NULL && e != NULL)
         *result = *e;
 
@@ -2974,4 +3023,365 @@ int FC_CalcRequiredHeight( FC_Font* font, FC_Target* dest, FC_Rect box, FC_Align
     }
 
     return y - box.y;
-}
\ No newline at end of file
+}
+
+static Uint32 FC_GetGlyphCacheLevelBytes( FC_Image* level )
+{
+    int w = 0, h = 0;
+    if( level == NULL )
+    {
+        return 0;
+    }
+
+    #ifdef FC_USE_SDL_GPU
+    w = level->w;
+    h = level->h;
+    #else
+    SDL_QueryTexture( level, NULL, NULL, &w, &h );
+    #endif
+    return (Uint32)( w * h * 4 );
+}
+
+static Uint32 FC_GetAtlasBytes( FC_Font* font )
+{
+    int i;
+    Uint32 total = 0;
+    for( i = 0; i < font->glyph_cache_count; ++i )
+    {
+        total += FC_GetGlyphCacheLevelBytes( font->glyph_cache[ i ] );
+    }
+    return total;
+}
+
+// Called when the packing cursor has run off the end of its cache level
+static Uint8 FC_MakeRoomInGlyphCache( FC_Font* font )
+{
+    int i;
+    int victim = -1;
+    Uint32 victim_last_used = 0;
+    Uint32 level_bytes = font->glyph_cache_count ? FC_GetGlyphCacheLevelBytes( font->glyph_cache[ 0 ] ) : 0;
+
+    // within budget: grow as usual
+    if( font->atlas_budget == 0 || FC_GetAtlasBytes( font ) + level_bytes <= font->atlas_budget )
+    {
+        return FC_GrowGlyphCache( font );
+    }
+
+    // find the least recently used level that hasn't been drawn from this frame
+    // (its glyphs may still be queued in the renderer's batch)
+    for( i = 0; i < font->glyph_cache_count; ++i )
+    {
+        Uint32 last_used = font->glyph_cache_last_used[ i ];
+        if( last_used == font->frame )
+        {
+            continue;
+        }
+        if( victim == -1 || last_used < victim_last_used )
+        {
+            victim = i;
+            victim_last_used = last_used;
+        }
+    }
+
+    // every level is in use: exceed the budget rather than corrupt this frame
+    if( victim == -1 )
+    {
+        return FC_GrowGlyphCache( font );
+    }
+
+    // evict the victim's glyphs: they keep their metrics, and are re-rasterized on demand
+    for( i = 0; i < font->glyphs->num_buckets; ++i )
+    {
+        FC_MapNode* node;
+        for( node = font->glyphs->buckets[ i ]; node != NULL; node = node->next )
+        {
+            if( node->value.cache_level == victim )
+            {
+                node->value.cache_level = FC_GLYPH_EVICTED;
+                font->atlas_stats.glyphs_evicted++;
+            }
+        }
+    }
+
+    // recycle the level and pack from its start
+    FC_ClearGlyphCacheLevel( font, font->glyph_cache[ victim ] );
+    font->glyph_cache_last_used[ victim ] = font->frame;
+    font->last_glyph.cache_level = victim;
+    font->last_glyph.rect.x = FC_CACHE_PADDING;
+    font->last_glyph.rect.y = FC_CACHE_PADDING;
+    font->last_glyph.rect.w = 0;
+    font->atlas_stats.evictions++;
+    return 1;
+}
+
+void FC_SetAtlasBudget( FC_Font* font, Uint32 bytes )
+{
+    if( font == NULL )
+    {
+        return;
+    }
+    font->atlas_budget = bytes;
+}
+
+Uint32 FC_GetAtlasBudget( FC_Font* font )
+{
+    if( font == NULL )
+    {
+        return 0;
+    }
+    return font->atlas_budget;
+}
+
+void FC_AdvanceFrame( FC_Font* font )
+{
+    if( font == NULL )
+    {
+        return;
+    }
+    font->frame++;
+}
+
+FC_AtlasStats FC_GetAtlasStats( FC_Font* font )
+{
+    FC_AtlasStats stats;
+    memset( &stats, 0, sizeof( FC_AtlasStats ) );
+    if( font == NULL )
+    {
+        return stats;
+    }
+
+    stats = font->atlas_stats;
+    stats.atlas_bytes = FC_GetAtlasBytes( font );
+    stats.num_levels = font->glyph_cache_count;
+    return stats;
+}
+
+void FC_InitMeasureContext( FC_MeasureContext* ctx )
+{
+    if( ctx == NULL )
+    {
+        return;
+    }
+    ctx->num_missing = 0;
+    ctx->num_lines = 0;
+}
+
+// Decodes one codepoint without reading past 'end'
+static Uint32 FC_NextCodepointBounded( const char** c, const char* end )
+{
+    Uint32 codepoint;
+    if( U8_charsize( *c ) > end - *c )
+    {
+        // truncated multibyte character
+        codepoint = (unsigned char)**c;
+        ++*c;
+        return codepoint;
+    }
+
+    codepoint = FC_GetCodepointFromUTF8( c, 1 );
+    ++*c;
+    return codepoint;
+}
+
+static void FC_RecordMissingGlyph( FC_MeasureContext* ctx, Uint32 codepoint )
+{
+    int i;
+    int recorded = FC_MIN( ctx->num_missing, FC_MEASURE_MAX_MISSING );
+    for( i = 0; i < recorded; ++i )
+    {
+        if( ctx->missing[ i ] == codepoint )
+        {
+            return;
+        }
+    }
+    if( ctx->num_missing < FC_MEASURE_MAX_MISSING )
+    {
+        ctx->missing[ ctx->num_missing ] = codepoint;
+    }
+    ctx->num_missing++;
+}
+
+// Read-only glyph width lookup; evicted glyphs keep their metrics
+static int FC_MeasureGlyph( FC_Font* font, FC_MeasureContext* ctx, Uint32 codepoint )
+{
+    FC_GlyphData* e = FC_MapFind( font->glyphs, codepoint );
+    if( e == NULL )
+    {
+        FC_RecordMissingGlyph( ctx, codepoint );
+        e = FC_MapFind( font->glyphs, ' ' );
+        if( e == NULL )
+        {
+            return 0;
+        }
+    }
+    return e->rect.w;
+}
+
+// Width of a run of text that contains no newlines
+static int FC_MeasureRun( FC_Font* font, FC_MeasureContext* ctx, const char* c, const char* end )
+{
+    int width = 0;
+    while( c < end )
+    {
+        width += FC_MeasureGlyph( font, ctx, FC_NextCodepointBounded( &c, end ) );
+    }
+    return width;
+}
+
+static void FC_RecordLineWidth( Uint16* widths, int max_widths, int line, int width )
+{
+    if( widths != NULL && line < max_widths )
+    {
+        widths[ line ] = (Uint16)width;
+    }
+}
+
+// Number of lines FC_GetBufferFitToColumn() would break a single line of text into.
+// The width of each (up to 'max_widths') is stored in 'widths', if not NULL.
+static int FC_CountWrappedLines( FC_Font* font, FC_MeasureContext* ctx, int width, const char* line, const char* end, Uint16* widths, int max_widths )
+{
+    const char* word;
+    const char* c;
+    int lines = 0;
+    int line_width = -1;
+    int run_width = FC_MeasureRun( font, ctx, line, end );
+
+    // fits as it is?
+    if( width <= 0 || run_width <= width )
+    {
+        FC_RecordLineWidth( widths, max_widths, 0, run_width );
+        return 1;
+    }
+
+    // add words (each with its trailing space) one at a time until we go over;
+    // the first word is always kept, so there is at least one word per line
+    word = line;
+    for( c = line; ; ++c )
+    {
+        if( c == end || *c == ' ' || *c == '\t' )
+        {
+            int word_width = FC_MeasureRun( font, ctx, word, c );
+            int space_width = ( c == end ) ? 0 : FC_MeasureRun( font, ctx, c, c + 1 );
+            if( line_width < 0 )
+            {
+                line_width = word_width + space_width;
+            }
+            else if( line_width + word_width > width )
+            {
+                FC_RecordLineWidth( widths, max_widths, lines, line_width );
+                ++lines;
+                line_width = word_width + space_width;
+            }
+            else
+            {
+                line_width += word_width + space_width;
+            }
+
+            if( c == end )
+            {
+                break;
+            }
+            word = c + 1;
+        }
+    }
+
+    FC_RecordLineWidth( widths, max_widths, lines, line_width );
+    return lines + 1;
+}
+
+Uint16 FC_MeasureWidth( FC_Font* font, FC_MeasureContext* ctx, const char* text, size_t length )
+{
+    const char* line;
+    const char* c;
+    const char* end;
+    int big_width = 0;
+    if( font == NULL || ctx == NULL || text == NULL )
+    {
+        return 0;
+    }
+
+    end = text + length;
+    line = text;
+    for( c = text; c <= end; ++c )
+    {
+        if( c == end || *c == '\n' )
+        {
+            big_width = FC_MAX( big_width, FC_MeasureRun( font, ctx, line, c ) );
+            line = c + 1;
+        }
+    }
+    return (Uint16)big_width;
+}
+
+int FC_MeasureColumnHeight( FC_Font* font, FC_MeasureContext* ctx, int width, const char* text, size_t length )
+{
+    const char* line;
+    const char* c;
+    const char* end;
+    int lines = 0;
+    if( font == NULL || ctx == NULL || text == NULL )
+    {
+        return 0;
+    }
+
+    end = text + length;
+    line = text;
+    for( c = text; c <= end; ++c )
+    {
+        if( c == end || *c == '\n' )
+        {
+            lines += FC_CountWrappedLines( font, ctx, width, line, c, NULL, 0 );
+            line = c + 1;
+        }
+    }
+
+    ctx->num_lines = lines;
+    return lines * FC_GetLineHeight( font );
+}
+
+int FC_MeasureLineWidths( FC_Font* font, FC_MeasureContext* ctx, int width, const char* text, size_t length, Uint16* widths, int max_lines )
+{
+    const char* line;
+    const char* c;
+    const char* end;
+    int lines = 0;
+    if( font == NULL || ctx == NULL || text == NULL )
+    {
+        return 0;
+    }
+
+    end = text + length;
+    line = text;
+    for( c = text; c <= end; ++c )
+    {
+        if( c == end || *c == '\n' )
+        {
+            int remaining = FC_MAX( max_lines - lines, 0 );
+            lines += FC_CountWrappedLines( font, ctx, width, line, c, remaining ? widths + lines : NULL, remaining );
+            line = c + 1;
+        }
+    }
+
+    ctx->num_lines = lines;
+    return lines;
+}
+
+void FC_CacheGlyphs( FC_Font* font, const char* text, size_t length )
+{
+    const char* c;
+    const char* end;
+    if( font == NULL || text == NULL )
+    {
+        return;
+    }
+
+    end = text + length;
+    for( c = text; c < end; )
+    {
+        Uint32 codepoint = FC_NextCodepointBounded( &c, end );
+        if( codepoint != '\n' )
+        {
+            FC_GetGlyphData( font, NULL, codepoint );
+        }
+    }
+}
@@ -104,10 +104,25 @@ typedef struct FC_Font FC_Font;
 typedef struct FC_GlyphData
 {
     SDL_Rect rect;
-    int cache_level;
+    int cache_level;    // FC_GLYPH_EVICTED once its cache level has been recycled
+    Uint32 last_used;   // frame stamp, see FC_AdvanceFrame()
 
 } FC_GlyphData;
 
+// cache_level of a glyph whose cache level was recycled; its rect.w is still valid for measuring
+#define FC_GLYPH_EVICTED -1
+
+typedef struct FC_AtlasStats
+{
+    Uint32 atlas_bytes;         // texture memory held by the glyph cache levels
+    int num_levels;
+    Uint32 evictions;           // cache levels recycled to stay within budget
+    Uint32 glyphs_evicted;
+    Uint32 rasterizations;      // glyphs rendered with SDL_ttf after loading
+    Uint32 rerasterizations;    // ... of which had previously been evicted
+
+} FC_AtlasStats;
+
 
 
 
@@ -324,6 +339,47 @@ void FC_SetDefaultColor(FC_Font* font, SDL_Color color);
 // Calculate the height required for the supplied text, given the width of 'box'
 int FC_CalcRequiredHeight( FC_Font* font, FC_Target* dest, FC_Rect box, FC_AlignEnum align, const char* formatted_text, ... );
 
+// Limit the texture memory used by the glyph cache levels (0 = unlimited, the default).
+// When a new level would exceed the budget, the least recently used level is cleared and
+// reused instead, and the glyphs on it are re-rasterized on demand.
+void FC_SetAtlasBudget( FC_Font* font, Uint32 bytes );
+Uint32 FC_GetAtlasBudget( FC_Font* font );
+
+// Start a new frame: glyphs drawn from here on are stamped with the new frame number.
+// Cache levels used during the current frame are never evicted.
+void FC_AdvanceFrame( FC_Font* font );
+
+FC_AtlasStats FC_GetAtlasStats( FC_Font* font );
+
+// Caller-owned scratch state for the re-entrant measuring functions below.
+// Each thread that measures concurrently needs its own context.
+#define FC_MEASURE_MAX_MISSING 32
+
+typedef struct FC_MeasureContext
+{
+    Uint32 missing[FC_MEASURE_MAX_MISSING];     // distinct codepoints that had no glyph data
+    int num_missing;                            // may exceed FC_MEASURE_MAX_MISSING
+    int num_lines;                              // lines counted by the last FC_MeasureColumnHeight()
+
+} FC_MeasureContext;
+
+void FC_InitMeasureContext( FC_MeasureContext* ctx );
+
+// Non-variadic, re-entrant counterparts of FC_GetWidth() and FC_CalcRequiredHeight().
+// They neither touch the shared format buffer nor rasterize glyphs: they only read glyph
+// metrics, so any number of threads may measure at once while no thread modifies the font.
+// Uncached glyphs are measured as a space and recorded in the context; cache them with
+// FC_CacheGlyphs() and measure again to get the same result as the variadic functions.
+Uint16 FC_MeasureWidth( FC_Font* font, FC_MeasureContext* ctx, const char* text, size_t length );
+int FC_MeasureColumnHeight( FC_Font* font, FC_MeasureContext* ctx, int width, const char* text, size_t length );
+
+// Same wrapping as FC_MeasureColumnHeight(), but returns the number of lines and stores the
+// width of each of the first 'max_lines' in 'widths' (trailing spaces included).
+int FC_MeasureLineWidths( FC_Font* font, FC_MeasureContext* ctx, int width, const char* text, size_t length, Uint16* widths, int max_lines );
+
+// Rasterize the glyphs of the given text that aren't cached yet (uses the renderer, so not thread-safe)
+void FC_CacheGlyphs( FC_Font* font, const char* text, size_t length );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,105 @@
+// bench/Alloc.cpp
+// checks that steady-state frames don't touch the heap, headless and unpaced
+//
+// usage: bench alloc [frames = 600] [warmup frames = 60]
+//
+// The mouse rests mid-window, hovering, and each frame scrolls one wheel tick,
+// alternating down and up so the view stays put. After the warmup, every frame's
+// allocations are counted; frames that rebuilt the layout tree are structural and
+// only reported. Fails if any other frame allocated.
+
+#include "bench/Bench.hpp"
+#include "core/AllocTracker.hpp"
+#include "core/Application.hpp"
+#include "core/App.hpp"
+#include "core/Counters.hpp"
+#include "core/Render.hpp"
+#include "core/RenderBackend.hpp"
+
+#include<Console/Console.hpp>
+
+#include<memory>
+#include<utility>
+#include<vector>
+
+namespace Bench
+{
+  int Alloc( Args const& args )
+  {
+    auto const numFrames = ArgInt( args, 0, 600 );
+    auto const numWarmup = ArgInt( args, 1, 60 );
+
+    InputTrace const hover =
+    {
+      InputEvent{ .type = InputType::MouseMove, .x = AppWidth() / 2, .y = AppHeight() / 2 }
+    };
+    InputTrace const scrollDown =
+    {
+      InputEvent{ .type = InputType::Wheel, .wheel = -1 }
+    };
+    InputTrace const scrollUp =
+    {
+      InputEvent{ .type = InputType::Wheel, .wheel = 1 }
+    };
+
+    std::vector<FrameTimings> steady;
+    steady.reserve( numFrames );
+    std::vector<std::pair<int, FrameAllocations>> allocatingFrames;
+    allocatingFrames.reserve( numFrames );
+    auto relayoutFrames = 0;
+    {
+      Application app{ AppWidth(), AppHeight(), App(), true };
+      Render::SetBackend( std::make_unique<NullBackend>() );
+      app.Start();
+
+      // warm up: let every pool, queue and cache reach its working size
+      app.Step( hover );
+      for( auto frame = 0; frame < numWarmup; ++frame )
+      {
+        app.Step( frame % 2 ? scrollUp : scrollDown );
+      }
+
+      AllocTracker::Enable();
+      for( auto frame = 0; frame < numFrames; ++frame )
+      {
+        auto const timings = app.Step( frame % 2 ? scrollUp : scrollDown );
+
+        // layout rebuilds allocate their trees, so are structural
+        if( Counters::LastFrame( Counters::LayoutNodesBuilt ) > 0 )
+        {
+          ++relayoutFrames;
+          continue;
+        }
+
+        steady.push_back( timings );
+        if( timings.allocations.total.allocations )
+        {
+          allocatingFrames.emplace_back( frame, timings.allocations );
+        }
+      }
+      AllocTracker::Enable( false );
+    }
+
+    // report
+    Console::PrintLn( "{} frames after {} warmup, {} steady, {} rebuilt the layout", numFrames, numWarmup, steady.size(), relayoutFrames );
+    PrintFrameAllocations( steady );
+
+    // early exit: zero allocations
+    if( allocatingFrames.empty() )
+    {
+      Console::PrintLn( "ok: no steady frame allocated" );
+      return 0;
+    }
+
+    Console::ErrorLn( "FAILED: {} steady frames allocated", allocatingFrames.size() );
+    Console::ErrorLn( "{:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}", "frame", "input", "hitTest", "flush", "layout", "render", "present", "bytes" );
+    for( auto const& [ frame, allocations ] : allocatingFrames )
+    {
+      Console::ErrorLn( "{:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}", frame,
+        allocations.input.allocations, allocations.hitTest.allocations, allocations.flush.allocations,
+        allocations.layout.allocations, allocations.render.allocations, allocations.present.allocations, allocations.total.bytes );
+    }
+    return 1;
+  }
+
+} // namespace Bench
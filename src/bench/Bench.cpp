@@ -0,0 +1,129 @@
+// bench/Bench.cpp
+
+#include "bench/Bench.hpp"
+#include "core/Application.hpp"
+
+#include<Console/Console.hpp>
+
+#include<algorithm>
+#include<array>
+#include<charconv>
+#include<cmath>
+
+namespace Bench
+{
+  int ArgInt( Args const& args, size_t index, int fallback )
+  {
+    if( index >= args.size() )
+    {
+      return fallback;
+    }
+
+    auto arg = args.at( index );
+    int value = fallback;
+    std::from_chars( arg.data(), arg.data() + arg.size(), value );
+    return value;
+  }
+
+  double Milliseconds( Clock::duration d )
+  {
+    return std::chrono::duration<double, std::milli>( d ).count();
+  }
+
+  double Percentile( std::vector<double> samples, double p )
+  {
+    if( samples.empty() )
+    {
+      return 0.0;
+    }
+
+    // nearest rank
+    auto rank = static_cast<size_t>( std::ceil( p / 100.0 * samples.size() ) );
+    auto index = std::clamp<size_t>( rank, 1, samples.size() ) - 1;
+    std::nth_element( samples.begin(), samples.begin() + index, samples.end() );
+    return samples.at( index );
+  }
+
+  void PrintFrameTimings( std::vector<FrameTimings> const& timings )
+  {
+    struct Phase
+    {
+      std::string_view name;
+      double FrameTimings::* ms;
+    };
+    static constexpr std::array s_Phases =
+    {
+      Phase{ "input",   &FrameTimings::input },
+      Phase{ "hitTest", &FrameTimings::hitTest },
+      Phase{ "flush",   &FrameTimings::flush },
+      Phase{ "layout",  &FrameTimings::layout },
+      Phase{ "render",  &FrameTimings::render },
+      Phase{ "present", &FrameTimings::present },
+      Phase{ "total",   &FrameTimings::total },
+      Phase{ "latency", &FrameTimings::latency },
+    };
+
+    Console::PrintLn( "{:>8} {:>10} {:>10} {:>10} {:>10} {:>10}", "phase", "mean ms", "p50", "p95", "p99", "max" );
+    for( auto const& phase : s_Phases )
+    {
+      std::vector<double> samples;
+      samples.reserve( timings.size() );
+      auto sum = 0.0;
+      for( auto const& frame : timings )
+      {
+        samples.push_back( frame.*phase.ms );
+        sum += frame.*phase.ms;
+      }
+
+      Console::PrintLn( "{:>8} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}",
+        phase.name, sum / std::max<size_t>( samples.size(), 1 ),
+        Percentile( samples, 50.0 ), Percentile( samples, 95.0 ), Percentile( samples, 99.0 ), Percentile( samples, 100.0 ) );
+    }
+
+    // early exit: allocations weren't counted
+    if( !AllocTracker::IsEnabled() )
+    {
+      return;
+    }
+
+    PrintFrameAllocations( timings );
+  }
+
+  void PrintFrameAllocations( std::vector<FrameTimings> const& timings )
+  {
+    struct Phase
+    {
+      std::string_view name;
+      AllocTracker::Count FrameAllocations::* count;
+    };
+    static constexpr std::array s_Phases =
+    {
+      Phase{ "input",   &FrameAllocations::input },
+      Phase{ "hitTest", &FrameAllocations::hitTest },
+      Phase{ "flush",   &FrameAllocations::flush },
+      Phase{ "layout",  &FrameAllocations::layout },
+      Phase{ "render",  &FrameAllocations::render },
+      Phase{ "present", &FrameAllocations::present },
+      Phase{ "total",   &FrameAllocations::total },
+    };
+
+    Console::PrintLn( "{:>8} {:>10} {:>10} {:>12}", "phase", "mean allocs", "max", "mean bytes" );
+    for( auto const& phase : s_Phases )
+    {
+      uint64_t allocations = 0;
+      uint64_t maxAllocations = 0;
+      uint64_t bytes = 0;
+      for( auto const& frame : timings )
+      {
+        auto const& count = frame.allocations.*phase.count;
+        allocations += count.allocations;
+        maxAllocations = std::max( maxAllocations, count.allocations );
+        bytes += count.bytes;
+      }
+
+      auto const frames = static_cast<double>( std::max<size_t>( timings.size(), 1 ) );
+      Console::PrintLn( "{:>8} {:>10.1f} {:>10} {:>12.1f}", phase.name, allocations / frames, maxAllocations, bytes / frames );
+    }
+  }
+
+} // namespace Bench
@@ -0,0 +1,53 @@
+// bench/Bench.hpp
+// benchmarks for the engine, run as 'bench <name> [args...]'
+
+#ifndef BENCH_BENCH_HPP_INCLUDED
+#define BENCH_BENCH_HPP_INCLUDED
+
+#include<chrono>
+#include<functional>
+#include<string_view>
+#include<vector>
+
+struct FrameTimings;
+
+namespace Bench
+{
+  using Clock = std::chrono::steady_clock;
+  using Args  = std::vector<std::string_view>;
+  using Benchmark = std::function< int( Args const& ) >;
+
+  ///////////////
+  // utilities //
+  ///////////////
+
+  // positional integer argument, or 'fallback' if absent
+  int ArgInt( Args const& args, size_t index, int fallback );
+
+  double Milliseconds( Clock::duration d );
+
+  // p in [0, 100]
+  double Percentile( std::vector<double> samples, double p );
+
+  // a table of each phase's mean and percentiles, then allocations if they were counted
+  void PrintFrameTimings( std::vector<FrameTimings> const& timings );
+
+  // a table of each phase's allocations
+  void PrintFrameAllocations( std::vector<FrameTimings> const& timings );
+
+  ////////////////
+  // benchmarks //
+  ////////////////
+
+  int TextMeasure( Args const& args );
+  int Frames( Args const& args );
+  int Raster( Args const& args );
+  int Scroll( Args const& args );
+  int Alloc( Args const& args );
+  int Children( Args const& args );
+  int Recycle( Args const& args );
+  int Observers( Args const& args );
+
+} // namespace Bench
+
+#endif
@@ -0,0 +1,99 @@
+// bench/Children.cpp
+// SetChildren() on a long keyed list, and rebuilding its layout after
+//
+// usage: bench children [children = 10000]
+//
+// Each child is a padded column, keyed by a number. Each step reshapes the list from
+// the one before: the same again, reversed, one moved to the front, every other one
+// removed and put back, then shuffled.
+
+#include "bench/Bench.hpp"
+#include "core/Database.hpp"
+#include "core/ui/Widgets.hpp"
+
+#include<Console/Console.hpp>
+
+#include<algorithm>
+#include<functional>
+#include<numeric>
+#include<random>
+#include<string>
+#include<vector>
+
+namespace Bench
+{
+  int Children( Args const& args )
+  {
+    auto const numChildren = std::max( ArgInt( args, 0, 10000 ), 2 );
+
+    auto const list = Column( AutoWidth, AutoHeight, {} );
+    InitWidgetTree( list, NullKey );
+
+    // children by number
+    auto describe = [] ( std::vector<int> const& numbers )
+    {
+      std::vector<ChildDescriptor> children;
+      children.reserve( numbers.size() );
+      for( auto const number : numbers )
+      {
+        children.push_back( ChildDescriptor
+          {
+            .key = std::to_string( number ),
+            .create = [] ()
+            {
+              return Padding( AutoWidth, AutoHeight, 2, 2, 2, 2, Column( AutoWidth, HeightExactly( 20 ), {} ) );
+            }
+          }
+        );
+      }
+      return children;
+    };
+
+    std::vector<int> numbers( numChildren );
+    std::iota( numbers.begin(), numbers.end(), 0 );
+    std::vector<int> const all = numbers;
+    std::mt19937 random{ 1 };
+
+    struct Step
+    {
+      std::string_view name;
+      std::function< void( std::vector<int>& ) > reshape;
+    };
+    std::vector<Step> const steps =
+    {
+      Step{ "create", [] ( std::vector<int>& ) { } },
+      Step{ "same", [] ( std::vector<int>& ) { } },
+      Step{ "reverse", [] ( std::vector<int>& n ) { std::ranges::reverse( n ); } },
+      Step{ "move one", [] ( std::vector<int>& n ) { std::rotate( n.begin(), n.end() - 1, n.end() ); } },
+      Step{ "remove half", [] ( std::vector<int>& n ) { std::erase_if( n, [] ( int number ) { return number % 2; } ); } },
+      Step{ "restore", [ &all ] ( std::vector<int>& n ) { n = all; } },
+      Step{ "shuffle", [ &random ] ( std::vector<int>& n ) { std::ranges::shuffle( n, random ); } },
+    };
+
+    Console::PrintLn( "{} children", numChildren );
+    Console::PrintLn( "{:>12} {:>10} {:>10} {:>8} {:>8} {:>8} {:>8}", "step", "diff ms", "layout ms", "created", "kept", "moved", "destroyed" );
+    for( auto const& step : steps )
+    {
+      step.reshape( numbers );
+      auto const children = describe( numbers );
+
+      auto const diffStart = Clock::now();
+      auto const changes = SetChildren( list, children );
+      auto const diffMs = Milliseconds( Clock::now() - diffStart );
+
+      auto const layoutStart = Clock::now();
+      if( ShouldRebuildLayoutTree() )
+      {
+        RebuildLayoutTree( list );
+      }
+      auto const layoutMs = Milliseconds( Clock::now() - layoutStart );
+
+      Console::PrintLn( "{:>12} {:>10.3f} {:>10.3f} {:>8} {:>8} {:>8} {:>8}",
+        step.name, diffMs, layoutMs, changes.created, changes.kept, changes.moved, changes.destroyed );
+    }
+
+    DestroyWidget( list );
+    return 0;
+  }
+
+} // namespace Bench
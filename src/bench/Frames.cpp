@@ -0,0 +1,125 @@
+// bench/Frames.cpp
+// whole frames of the app, headless and unpaced, optionally replaying recorded input
+//
+// usage: bench frames [frames = 1000] [input trace, or - for none] [backend = sdl | sdl-gfx | null | software]
+//                     [threads = single | render-thread]
+//
+// Record a trace with 'app --record <trace file>'. Longer runs loop the trace.
+// sdl-gfx draws rounded boxes with SDL2_gfx rather than nine-slice textures.
+// The software backend saves the last frame to bench-frames.ppm.
+// render-thread replays each frame's draws on a render thread (see core/RenderThread.hpp).
+
+#include "bench/Bench.hpp"
+#include "core/Application.hpp"
+#include "core/App.hpp"
+#include "core/Counters.hpp"
+#include "core/Render.hpp"
+#include "core/RenderBackend.hpp"
+
+#include<Console/Console.hpp>
+
+#include<memory>
+#include<stdexcept>
+#include<string>
+
+namespace Bench
+{
+  int Frames( Args const& args )
+  {
+    auto const numFrames = ArgInt( args, 0, 1000 );
+    auto const tracePath = args.size() > 1 && args.at( 1 ) != "-" ? std::string{ args.at( 1 ) } : std::string{};
+    auto const backend = args.size() > 2 ? args.at( 2 ) : std::string_view{ "sdl" };
+    if( backend != "sdl" && backend != "sdl-gfx" && backend != "null" && backend != "software" )
+    {
+      throw std::runtime_error{ std::format( "Unknown backend '{}'", backend ) };
+    }
+    auto const threads = args.size() > 3 ? args.at( 3 ) : std::string_view{ "single" };
+    if( threads != "single" && threads != "render-thread" )
+    {
+      throw std::runtime_error{ std::format( "Unknown threading '{}'", threads ) };
+    }
+
+    // bucket the trace's input by frame; quitting is up to us
+    std::vector<InputTrace> inputByFrame;
+    if( tracePath.size() )
+    {
+      for( auto const& event : LoadInputTrace( tracePath ) )
+      {
+        if( event.type == InputType::Quit )
+        {
+          continue;
+        }
+        if( event.frame >= inputByFrame.size() )
+        {
+          inputByFrame.resize( event.frame + 1 );
+        }
+        inputByFrame.at( event.frame ).push_back( event );
+      }
+    }
+
+    NullBackend* nullBackend = nullptr;
+    SoftwareBackend* softwareBackend = nullptr;
+    std::vector<FrameTimings> timings;
+    timings.reserve( numFrames );
+    {
+      Application app{ AppWidth(), AppHeight(), App(), true };
+      if( backend == "sdl-gfx" )
+      {
+        Render::SetBackend( std::make_unique<SdlBackend>( Render::GetRenderer(), false ) );
+      }
+      else if( backend == "null" )
+      {
+        auto owned = std::make_unique<NullBackend>();
+        nullBackend = owned.get();
+        Render::SetBackend( std::move( owned ) );
+      }
+      else if( backend == "software" )
+      {
+        auto owned = std::make_unique<SoftwareBackend>( AppWidth(), AppHeight() );
+        softwareBackend = owned.get();
+        Render::SetBackend( std::move( owned ) );
+      }
+      if( threads == "render-thread" )
+      {
+        app.UseRenderThread();
+      }
+      app.Start();
+
+      InputTrace const noInput;
+      for( auto frame = 0; frame < numFrames; ++frame )
+      {
+        auto const& input = inputByFrame.empty() ? noInput : inputByFrame.at( frame % inputByFrame.size() );
+        timings.push_back( app.Step( input ) );
+      }
+
+      // NB: the app's destructor waits for the render thread to finish
+    }
+
+    // report
+    Console::PrintLn( "{} frames, {} backend, {}, {}", numFrames, backend, threads,
+      tracePath.size() ? std::format( "replaying '{}' ({} frames)", tracePath, inputByFrame.size() ) : std::string{ "no input" } );
+    PrintFrameTimings( timings );
+
+    Console::PrintLn( "per frame: {:.1f} draw calls, {:.1f} geometry batches, {:.1f} glyphs",
+      Counters::Average( Counters::DrawCalls ), Counters::Average( Counters::GeometryBatches ), Counters::Average( Counters::GlyphsDrawn ) );
+    Console::PrintLn( "culled per frame: {:.1f} draws, {:.1f} widgets",
+      Counters::Average( Counters::CulledDraws ), Counters::Average( Counters::CulledWidgets ) );
+    Console::PrintLn( "callbacks per frame: {:.1f} observers, {:.1f} deferred",
+      Counters::Average( Counters::ObserverCallbacks ), Counters::Average( Counters::DeferredCallbacks ) );
+
+    if( nullBackend )
+    {
+      auto const& stats = nullBackend->GetStats();
+      Console::PrintLn( "commands: {} rects, {} filled rects, {} rounded boxes, {} texts ({} bytes), {} clip changes",
+        stats.rects, stats.filledRects, stats.roundedBoxes, stats.texts, stats.textBytes, stats.clipChanges );
+    }
+
+    if( softwareBackend )
+    {
+      softwareBackend->SavePpm( "bench-frames.ppm" );
+      Console::PrintLn( "last frame saved to bench-frames.ppm" );
+    }
+    return 0;
+  }
+
+} // namespace Bench
@@ -0,0 +1,104 @@
+// bench/Observers.cpp
+// subscribing and unsubscribing observers, after checking they hear what they should
+//
+// usage: bench observers [subscriptions = 10000]
+//
+// The check unsubscribes a handle twice, subscribing again in between: the second
+// time must leave the new observer, which has the same slot, alone. Then it sets a
+// state in the normal lane and again in the input lane: the second must win, and be
+// what observers are told. Last, it destroys a widget before flushing a state marked
+// dirty at its creation, which nothing observes. Fails if any of these go wrong.
+
+#include "bench/Bench.hpp"
+#include "core/Database.hpp"
+#include "core/ui/Widgets.hpp"
+
+#include<Console/Console.hpp>
+
+#include<algorithm>
+#include<optional>
+#include<vector>
+
+namespace Bench
+{
+  int Observers( Args const& args )
+  {
+    auto const numSubscriptions = std::max( ArgInt( args, 0, 10000 ), 1 );
+
+    auto const observed = Column( AutoWidth, AutoHeight, {} );
+    auto const observer = Column( AutoWidth, AutoHeight, {} );
+    InitWidgetTree( observed, NullKey );
+    InitWidgetTree( observer, NullKey );
+    auto hover = [ observed ] ()
+    {
+      SetState<WidgetState>( observed, [] ( WidgetState& state ) { state.isHovered = !state.isHovered; } );
+      FlushCallbacks();
+    };
+
+    // check
+    auto const stale = SubscribeState<WidgetState>( observer, observed, [] ( Key, WidgetState const& ) { } );
+    Unsubscribe( stale );
+    auto isTold = false;
+    SubscribeState<WidgetState>( observer, observed, [ &isTold ] ( Key, WidgetState const& ) { isTold = true; } );
+    Unsubscribe( stale );
+    hover();
+    if( !isTold )
+    {
+      Console::ErrorLn( "FAILED: unsubscribing a stale handle removed another observer" );
+      return 1;
+    }
+    Console::PrintLn( "ok: stale handles unsubscribe nothing" );
+
+    // a newer set in a higher lane applies after an older one in a lower lane, and
+    // observers are told the result
+    auto told = std::optional<bool>{};
+    SubscribeState<WidgetState>( observer, observed, [ &told ] ( Key, WidgetState const& state ) { told = state.isHovered; } );
+    SetState<WidgetState>( observed, [] ( WidgetState& state ) { state.isHovered = true; } );
+    SetState<WidgetState>( observed, [] ( WidgetState& state ) { state.isHovered = false; }, Lane::Input );
+    FlushCallbacks();
+    if( GetState<WidgetState>( observed ).isHovered || told != false )
+    {
+      Console::ErrorLn( "FAILED: an older set in a lower lane overwrote a newer one" );
+      return 1;
+    }
+    Console::PrintLn( "ok: sets to a state apply in order across lanes" );
+
+    // a state marked dirty at creation, but never observed, is dropped with its widget
+    // (this throws if not)
+    auto const unobserved = Column( AutoWidth, AutoHeight, {} );
+    InitWidgetTree( unobserved, NullKey );
+    CreateState<Transform>( unobserved, Transform{}, true );
+    DestroyWidget( unobserved );
+    FlushCallbacks();
+    Console::PrintLn( "ok: unobserved dirty states go with their widget" );
+
+    // time
+    std::vector<ObserverHandle> handles;
+    handles.reserve( numSubscriptions );
+    auto const subscribeStart = Clock::now();
+    for( auto i = 0; i < numSubscriptions; ++i )
+    {
+      handles.push_back( SubscribeState<WidgetState>( observer, observed, [] ( Key, WidgetState const& ) { } ) );
+    }
+    auto const subscribeMs = Milliseconds( Clock::now() - subscribeStart );
+
+    auto const notifyStart = Clock::now();
+    hover();
+    auto const notifyMs = Milliseconds( Clock::now() - notifyStart );
+
+    auto const unsubscribeStart = Clock::now();
+    for( auto const handle : handles )
+    {
+      Unsubscribe( handle );
+    }
+    auto const unsubscribeMs = Milliseconds( Clock::now() - unsubscribeStart );
+
+    Console::PrintLn( "{} observers: subscribing {:.3f} ms, telling them {:.3f} ms, unsubscribing {:.3f} ms",
+      numSubscriptions, subscribeMs, notifyMs, unsubscribeMs );
+
+    DestroyWidget( observer );
+    DestroyWidget( observed );
+    return 0;
+  }
+
+} // namespace Bench
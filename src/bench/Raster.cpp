@@ -0,0 +1,93 @@
+// bench/Raster.cpp
+// software rasterization kernels, per instruction set, in megapixels per second
+//
+// usage: bench raster [width = 1920] [height = 1080] [repeats = 20]
+
+#include "bench/Bench.hpp"
+#include "core/Raster.hpp"
+#include "core/RenderBackend.hpp"
+
+#include<Console/Console.hpp>
+
+#include<array>
+#include<map>
+
+namespace Bench
+{
+  int Raster( Args const& args )
+  {
+    auto const width   = ArgInt( args, 0, 1920 );
+    auto const height  = ArgInt( args, 1, 1080 );
+    auto const repeats = ArgInt( args, 2, 20 );
+
+    // a mask with every coverage value, as glyphs and corners have
+    std::vector<uint8_t> mask( static_cast<size_t>( width ) * height );
+    for( auto i = 0; i < mask.size(); ++i )
+    {
+      mask.at( i ) = static_cast<uint8_t>( i * 7 );
+    }
+
+    struct Kernel
+    {
+      std::string_view name;
+      std::function< void( SoftwareBackend& ) > draw;
+    };
+    auto const kernels = std::array
+    {
+      Kernel{ "fill",
+        [ & ] ( SoftwareBackend& fb ) { fb.DrawFilledRect( { 0, 0, width, height }, rgba32{ 40, 80, 120, 255 } ); } },
+      Kernel{ "blend",
+        [ & ] ( SoftwareBackend& fb ) { fb.DrawFilledRect( { 0, 0, width, height }, rgba32{ 200, 100, 50, 100 } ); } },
+      Kernel{ "mask",
+        [ & ] ( SoftwareBackend& fb ) { fb.DrawMask( 0, 0, width, height, mask.data(), width, rgba32{ 255, 255, 255, 230 } ); } },
+      Kernel{ "rounded",
+        [ & ] ( SoftwareBackend& fb ) { fb.DrawRoundedBox( { 0, 0, width, height }, 24, rgba32{ 0, 128, 255, 180 } ); } },
+    };
+
+    std::vector<::Raster::Isa> isas;
+    for( auto isa = 0; isa <= static_cast<int>( ::Raster::DetectIsa() ); ++isa )
+    {
+      isas.push_back( static_cast<::Raster::Isa>( isa ) );
+    }
+
+    Console::PrintLn( "{}x{}, {} repeats", width, height, repeats );
+    Console::PrintLn( "{:>8} {:>8} {:>10} {:>10} {:>8}", "kernel", "isa", "ms", "MP/s", "speedup" );
+    for( auto const& kernel : kernels )
+    {
+      double scalarMs = 0.0;
+      std::vector<rgba32> scalarPixels;
+      for( auto const isa : isas )
+      {
+        ::Raster::SetIsa( isa );
+        SoftwareBackend fb{ width, height };
+        fb.ClearScreen();
+
+        auto start = Clock::now();
+        for( auto r = 0; r < repeats; ++r )
+        {
+          kernel.draw( fb );
+        }
+        auto ms = Milliseconds( Clock::now() - start ) / repeats;
+
+        // every instruction set must draw the same pixels
+        if( isa == ::Raster::Isa::Scalar )
+        {
+          scalarMs = ms;
+          scalarPixels = fb.Pixels();
+        }
+        else if( !( fb.Pixels() == scalarPixels ) )
+        {
+          Console::ErrorLn( "{}: {} differs from scalar.", kernel.name, ::Raster::Name( isa ) );
+          return 1;
+        }
+
+        Console::PrintLn( "{:>8} {:>8} {:>10.3f} {:>10.1f} {:>7.2f}x",
+          kernel.name, ::Raster::Name( isa ), ms, width * height / ( ms * 1000.0 ), scalarMs / ms );
+      }
+    }
+
+    ::Raster::SetIsa( ::Raster::DetectIsa() );
+    return 0;
+  }
+
+} // namespace Bench
@@ -0,0 +1,113 @@
+// bench/Recycle.cpp
+// making chat messages with SetChildren(), with and without recycling
+//
+// usage: bench recycle [messages = 1000] [rounds = 20]
+//
+// Each round replaces a list of chat messages with as many new ones, as a virtualized
+// list would on paging. Recycled messages come from the pool, rebound to their new
+// entries; the others are made from scratch. Untimed, the list is first filled, then
+// a hovered message is paged away and un-hovered, which must do nothing.
+
+#include "bench/Bench.hpp"
+#include "core/AllocTracker.hpp"
+#include "core/Database.hpp"
+#include "core/ui/Widgets.hpp"
+#include "user/ui/Widgets.hpp"
+
+#include<Console/Console.hpp>
+
+#include<algorithm>
+#include<format>
+#include<string>
+#include<vector>
+
+namespace Bench
+{
+  int Recycle( Args const& args )
+  {
+    auto const numMessages = std::max( ArgInt( args, 0, 1000 ), 1 );
+    auto const numRounds = std::max( ArgInt( args, 1, 20 ), 1 );
+
+    // a page of entries per round (and two to start), the authors mixed
+    std::vector<ChatEntry> entries;
+    entries.reserve( static_cast<size_t>( numMessages ) * ( numRounds + 2 ) );
+    for( auto i = 0; i < numMessages * ( numRounds + 2 ); ++i )
+    {
+      entries.push_back( ChatEntry{ .author = i % 3 ? "Jane" : "Luke", .speech = std::format( "Message number {}", i ) } );
+    }
+
+    // room for a whole page
+    SetWidgetPoolLimit( numMessages );
+
+    Console::PrintLn( "{} messages a round, {} rounds", numMessages, numRounds );
+    Console::PrintLn( "{:>10} {:>10} {:>14} {:>14} {:>10}", "", "ms/round", "messages/s", "allocs/message", "recycled" );
+    for( auto const isRecycling : { false, true } )
+    {
+      auto const list = Column( AutoWidth, AutoHeight, {} );
+      InitWidgetTree( list, NullKey );
+
+      auto page = [ & ] ( int round )
+      {
+        std::vector<ChildDescriptor> messages;
+        messages.reserve( numMessages );
+        for( auto i = round * numMessages; i < ( round + 1 ) * numMessages; ++i )
+        {
+          auto message = ChatMessageChild( std::to_string( i ), entries.at( i ) );
+          if( !isRecycling )
+          {
+            message.signature.clear();
+          }
+          messages.push_back( std::move( message ) );
+        }
+        return messages;
+      };
+
+      // fill
+      SetChildren( list, page( 0 ) );
+      FlushCallbacks();
+
+      // hover, page away (into the pool, if recycling), then un-hover as the app
+      // would, from here and from another thread
+      auto const hovered = GetChildWidgets( list ).front();
+      SetState<WidgetState>( hovered, [] ( WidgetState& state ) { state.isHovered = true; } );
+      FlushCallbacks();
+      SetChildren( list, page( 1 ) );
+      SetState<WidgetState>( hovered, [] ( WidgetState& state ) { state.isHovered = false; } );
+      PostState<WidgetState>( hovered, [] ( WidgetState& state ) { state.isHovered = false; } );
+      FlushCallbacks();
+      if( WidgetExists( hovered ) )
+      {
+        Console::ErrorLn( "FAILED: a paged away message still exists" );
+        return 1;
+      }
+
+      // page
+      auto ms = 0.0;
+      size_t recycled = 0;
+      AllocTracker::Count allocations;
+      for( auto round = 1; round <= numRounds; ++round )
+      {
+        auto const messages = page( round + 1 );
+
+        auto const start = Clock::now();
+        AllocTracker::Enable();
+        auto const allocationsBefore = AllocTracker::ThisThread();
+        recycled += SetChildren( list, messages ).recycled;
+        FlushCallbacks();
+        allocations += AllocTracker::ThisThread() - allocationsBefore;
+        AllocTracker::Enable( false );
+        ms += Milliseconds( Clock::now() - start );
+      }
+
+      auto const made = static_cast<double>( numMessages ) * numRounds;
+      Console::PrintLn( "{:>10} {:>10.3f} {:>14.0f} {:>14.1f} {:>10}", isRecycling ? "recycling" : "creating",
+        ms / numRounds, made / ( ms / 1000.0 ), allocations.allocations / made, recycled );
+
+      DestroyWidget( list );
+    }
+
+    SetWidgetPoolLimit( 0 );
+    return 0;
+  }
+
+} // namespace Bench
@@ -0,0 +1,63 @@
+// bench/Scroll.cpp
+// continuous scrolling through a long chat, headless and unpaced
+//
+// usage: bench scroll [messages = 10000] [frames = 600] [layer budget in MiB = 32]
+//
+// The mouse rests in the chat's left margin, scrolling down 3 wheel ticks a frame.
+// A layer budget of 0 turns off layers, so every visible bubble is drawn every frame.
+// Unlike 'frames', this opens a window: SDL's software renderer can't blend layers.
+
+#include "bench/Bench.hpp"
+#include "core/Application.hpp"
+#include "core/App.hpp"
+#include "core/Counters.hpp"
+#include "core/Render.hpp"
+#include "core/ui/Widgets.hpp"
+#include "user/ui/Widgets.hpp"
+
+#include<Console/Console.hpp>
+
+#include<vector>
+
+namespace Bench
+{
+  int Scroll( Args const& args )
+  {
+    auto const numMessages = ArgInt( args, 0, 10000 );
+    auto const numFrames = ArgInt( args, 1, 600 );
+    auto const budgetMiB = ArgInt( args, 2, 32 );
+
+    auto const setupStart = Clock::now();
+    Application app{ AppWidth(), AppHeight(), AppRoot( AppWidth(), AppHeight(), ChatApp( numMessages ) ) };
+    Render::SetLayerBudget( static_cast<size_t>( budgetMiB ) * 1024 * 1024 );
+    app.Start();
+    InputTrace const pointAtMargin =
+    {
+      InputEvent{ .type = InputType::MouseMove, .x = 7, .y = AppHeight() / 2 }
+    };
+    app.Step( pointAtMargin );
+    auto const setupMs = Milliseconds( Clock::now() - setupStart );
+
+    std::vector<FrameTimings> timings;
+    timings.reserve( numFrames );
+    InputTrace const scrollDown =
+    {
+      InputEvent{ .type = InputType::Wheel, .wheel = -3 }
+    };
+    for( auto frame = 0; frame < numFrames; ++frame )
+    {
+      timings.push_back( app.Step( scrollDown ) );
+    }
+
+    // report
+    auto const layers = Render::GetLayerCounters();
+    Console::PrintLn( "{} messages, {} frames scrolling, {} MiB layer budget ({:.1f} ms to set up)", numMessages, numFrames, budgetMiB, setupMs );
+    PrintFrameTimings( timings );
+    Console::PrintLn( "per frame: {:.1f} draw calls, {:.1f} glyphs, {:.1f} layer blits, {:.1f} layers drawn",
+      Counters::Average( Counters::DrawCalls ), Counters::Average( Counters::GlyphsDrawn ),
+      Counters::Average( Counters::LayerBlits ), Counters::Average( Counters::LayersDrawn ) );
+    Console::PrintLn( "layers: {} using {:.1f} MiB, {} evicted", layers.layers, layers.bytes / ( 1024.0 * 1024.0 ), layers.evictions );
+    return 0;
+  }
+
+} // namespace Bench
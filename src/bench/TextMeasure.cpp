@@ -0,0 +1,136 @@
+// bench/TextMeasure.cpp
+// throughput of re-entrant text measurement across threads
+//
+// usage: bench text-measure [messages = 20000] [repeats = 10] [width = 200]
+
+#include "bench/Bench.hpp"
+#include "core/GuiRuntime.hpp"
+#include "core/Render.hpp"
+
+#include<SDL_FontCache/SDL_FontCache.h>
+
+#include<Console/Console.hpp>
+
+#include<array>
+#include<string>
+#include<thread>
+
+// chat-like messages from a fixed vocabulary; deterministic across runs
+static std::vector<std::string> makeMessages( int count )
+{
+  static constexpr std::array s_Words =
+  {
+    "hey", "there!", "how", "was", "your", "day?", "I've", "had", "a", "terrible", "day.",
+    "it", "all", "started", "when", "I", "forgot", "my", "keys", "as", "left", "for", "work",
+    "what", "happened?", "the", "car", "by", "itself", "that's", "crazy", "you're", "pulling",
+    "leg", "speak", "sincerely", "wait", "how", "did", "you", "start", "without", "them??"
+  };
+
+  uint32_t seed = 2024;
+  auto next = [ &seed ] ()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  };
+
+  std::vector<std::string> messages;
+  messages.reserve( count );
+  for( auto i = 0; i < count; ++i )
+  {
+    std::string message;
+    auto numWords = 1 + next() % 40;
+    for( auto w = 0u; w < numWords; ++w )
+    {
+      if( w )
+      {
+        message += ' ';
+      }
+      message += s_Words.at( next() % s_Words.size() );
+    }
+    messages.push_back( std::move( message ) );
+  }
+  return messages;
+}
+
+// measure every message, striding the work across 'numThreads' threads
+static void measureAll( std::vector<std::string> const& messages, int width, int numThreads, std::vector<int>& heights )
+{
+  auto work = [ & ] ( int first )
+  {
+    FC_MeasureContext ctx;
+    for( auto i = static_cast<size_t>( first ); i < messages.size(); i += numThreads )
+    {
+      FC_InitMeasureContext( &ctx );
+      heights.at( i ) = Render::MeasureTextHeight( ctx, width, messages.at( i ) );
+    }
+  };
+
+  std::vector<std::jthread> workers;
+  for( auto t = 1; t < numThreads; ++t )
+  {
+    workers.emplace_back( work, t );
+  }
+  work( 0 );
+}
+
+namespace Bench
+{
+  int TextMeasure( Args const& args )
+  {
+    auto const numMessages = ArgInt( args, 0, 20000 );
+    auto const repeats     = ArgInt( args, 1, 10 );
+    auto const width       = ArgInt( args, 2, 200 );
+
+    GuiRuntime runtime{ 1, 1, true };
+
+    // glyphs are cached up front, on this thread
+    auto const messages = makeMessages( numMessages );
+    for( auto const& message : messages )
+    {
+      Render::CacheGlyphs( message );
+    }
+
+    // reference results: SDL_FontCache's own (variadic, non-re-entrant) measure, on this thread
+    std::vector<int> expected( messages.size() );
+    {
+      auto renderer = Render::LockRenderer();
+      for( auto i = 0; i < messages.size(); ++i )
+      {
+        SDL_Rect const box{ .w = width };
+        expected.at( i ) = FC_CalcRequiredHeight( Render::DefaultFont(), Render::GetRenderer(), box, FC_ALIGN_LEFT, "%s", messages.at( i ).c_str() );
+      }
+    }
+
+    Console::PrintLn( "{} messages, {} repeats, width {}", numMessages, repeats, width );
+    Console::PrintLn( "{:>8} {:>12} {:>14} {:>8}", "threads", "ms/pass", "msgs/s", "speedup" );
+
+    auto const maxThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    double singleThreaded = 0.0;
+    for( auto numThreads = 1u; numThreads <= maxThreads; numThreads *= 2 )
+    {
+      std::vector<int> heights( messages.size() );
+      auto start = Clock::now();
+      for( auto r = 0; r < repeats; ++r )
+      {
+        measureAll( messages, width, numThreads, heights );
+      }
+      auto msPerPass = Milliseconds( Clock::now() - start ) / repeats;
+      if( numThreads == 1 )
+      {
+        singleThreaded = msPerPass;
+      }
+
+      // measuring must not depend on the number of threads
+      if( heights != expected )
+      {
+        Console::ErrorLn( "Mismatched heights with {} threads.", numThreads );
+        return 1;
+      }
+
+      Console::PrintLn( "{:>8} {:>12.3f} {:>14.0f} {:>7.2f}x",
+        numThreads, msPerPass, numMessages / ( msPerPass / 1000.0 ), singleThreaded / msPerPass );
+    }
+    return 0;
+  }
+
+} // namespace Bench
@@ -0,0 +1,43 @@
+// bench/main.cpp
+
+#include "bench/Bench.hpp"
+
+#include<Console/Console.hpp>
+
+#include<map>
+
+int main( int argc, char* argv[] )
+{
+	static const std::map<std::string_view, Bench::Benchmark> s_Benchmarks =
+	{
+		{ "text-measure", Bench::TextMeasure },
+		{ "frames", Bench::Frames },
+		{ "raster", Bench::Raster },
+		{ "scroll", Bench::Scroll },
+		{ "alloc", Bench::Alloc },
+		{ "children", Bench::Children },
+		{ "recycle", Bench::Recycle },
+		{ "observers", Bench::Observers },
+	};
+
+	// early exit: unknown benchmark
+	if( argc < 2 || !s_Benchmarks.contains( argv[ 1 ] ) )
+	{
+		Console::ErrorLn( "usage: bench <name> [args...]" );
+		for( auto const& [ name, benchmark ] : s_Benchmarks )
+		{
+			Console::ErrorLn( "  {}", name );
+		}
+		return 1;
+	}
+
+	try
+	{
+		return s_Benchmarks.at( argv[ 1 ] )( Bench::Args{ argv + 2, argv + argc } );
+	}
+	catch( std::exception const& e )
+	{
+		std::cerr << "\nException caught: " << e.what() << '\n';
+		return 1;
+	}
+}
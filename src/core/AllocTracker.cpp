@@ -0,0 +1,59 @@
+// AllocTracker.cpp
+
+#include "AllocTracker.hpp"
+
+#include<atomic>
+#include<cstdlib>
+#include<new>
+
+namespace AllocTracker
+{
+  static std::atomic<bool> s_Enabled = false;
+
+  // constant-initialised, so counting never allocates itself
+  static thread_local Count t_Count;
+
+  void Enable( bool enable )
+  {
+    s_Enabled.store( enable, std::memory_order_relaxed );
+  }
+
+  bool IsEnabled()
+  {
+    return s_Enabled.load( std::memory_order_relaxed );
+  }
+
+  Count ThisThread()
+  {
+    return t_Count;
+  }
+
+} // namespace AllocTracker
+
+// the default array and nothrow forms call these, so count too
+
+void* operator new( std::size_t size )
+{
+  if( AllocTracker::s_Enabled.load( std::memory_order_relaxed ) )
+  {
+    ++AllocTracker::t_Count.allocations;
+    AllocTracker::t_Count.bytes += size;
+  }
+
+  // malloc( 0 ) may return nullptr
+  if( auto p = std::malloc( size ? size : 1 ) )
+  {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete( void* p ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+  std::free( p );
+}
@@ -0,0 +1,41 @@
+// AllocTracker.hpp
+// counts heap allocations, by replacing the global operator new
+//
+// Off until Enable(). While on, each thread counts its own allocations and the bytes
+// asked for; take ThisThread() before and after some work for what that work allocated.
+// Allocations with extended alignment aren't counted.
+
+#ifndef CORE_ALLOC_TRACKER_HPP_INCLUDED
+#define CORE_ALLOC_TRACKER_HPP_INCLUDED
+
+#include<cstdint>
+
+namespace AllocTracker
+{
+  struct Count
+  {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    Count operator-( Count const& since ) const
+    {
+      return Count{ .allocations = allocations - since.allocations, .bytes = bytes - since.bytes };
+    }
+
+    Count& operator+=( Count const& more )
+    {
+      allocations += more.allocations;
+      bytes += more.bytes;
+      return *this;
+    }
+  };
+
+  void Enable( bool enable = true );
+  bool IsEnabled();
+
+  // the calling thread's, while enabled
+  Count ThisThread();
+
+} // namespace AllocTracker
+
+#endif
@@ -1,73 +1,281 @@
 // Application.cpp
 
 #include "Application.hpp"
+#include "AllocTracker.hpp"
+#include "Counters.hpp"
 #include "Database.hpp"
+#include "Profiler.hpp"
 #include "Render.hpp"
+#include "RenderBackend.hpp"
+#include "RenderThread.hpp"
 #include "Timer.hpp"
+#include "ui/Widgets.hpp"
+
+#include<Console/Console.hpp>
 
 #include<SDL2/SDL.h>
 
-Application::Application( int w, int h, Key root )
-  : m_Gui{ w, h },
-		m_App{ root }
+#include<chrono>
+
+Application::Application( int w, int h, Key root, bool headless )
+  : m_Gui{ w, h, headless },
+		m_App{ root },
+		m_Width{ w },
+		m_Height{ h }
 { }
 
-void Application::Run()
+Application::~Application()
 {
-	// show Window
-	m_Gui.ShowWindow();
+	// give the backend back before the renderer goes
+	if( m_RenderThread )
+	{
+		Render::SetBackend( m_RenderThread->Stop() );
+	}
+}
 
-  // init m_App
-	InitWidgetTree( m_App, NullKey );
+void Application::UseRenderThread()
+{
+	// early exit: already
+	if( m_RenderThread )
+	{
+		return;
+	}
+
+	// early exit: the renderer can't draw from another thread
+	if( !Render::GetBackend().IsThreadSafe() )
+	{
+		SDL_RendererInfo info{};
+		SDL_GetRendererInfo( Render::GetRenderer(), &info );
+		Console::PrintLn( "A render thread is unavailable with the '{}' renderer; rendering on the UI thread instead.", info.name ? info.name : "unknown" );
+		return;
+	}
+
+	// Render records, and the render thread replays onto what Render was using
+	m_RenderThread = std::make_unique<RenderThread>();
+	m_RenderThread->Start( Render::SetBackend( std::make_unique<RecordingBackend>( *m_RenderThread ) ) );
+}
+
+void Application::ShowPerfHud()
+{
+	// early exit: already
+	if( m_Hud )
+	{
+		return;
+	}
 
-  // init main loop
-	int mouseX;
-	int mouseY;
-	SDL_GetMouseState( &mouseX, &mouseY );
-  Key prev_hovered = 0;
-	bool finished = false;
-	Timer<60> timer;
-	while( !finished )
+	m_Hud = PerfHud( m_Width, m_Height / 2, RoundedBoxFormat{ .colour = { 255, 255, 255, 224 }, .radius = 8 } );
+}
+
+void Application::Run( RunOptions const& options )
+{
+	Start();
+
+	// pacing
+	auto pacing = options.pacing;
+	auto fps = options.fps;
+	if( fps <= 0 )
+	{
+		SDL_DisplayMode mode;
+		fps = SDL_GetCurrentDisplayMode( 0, &mode ) == 0 && mode.refresh_rate > 0 ? mode.refresh_rate : 60;
+	}
+	if( pacing == Pacing::VSync && SDL_RenderSetVSync( Render::GetRenderer(), 1 ) != 0 )
+	{
+		Console::PrintLn( "VSync unavailable ({}); pacing to {} fps instead.", SDL_GetError(), fps );
+		pacing = Pacing::Fixed;
+	}
+
+	// init main loop
+	InputTrace input;
+	InputTrace recording;
+	Timer timer{ pacing, fps };
+
+	// other threads' PostState() shouldn't wait out the sleep
+	OnStatePosted( [ &timer ] () { timer.Wake(); } );
+	while( !m_Finished )
 	{ 
-		// rebuild?
-		if( ShouldRebuildLayoutTree() )
+		// poll events
+		input.clear();
 		{
-			RebuildLayoutTree( m_App );
+			DRUI_PROFILE_SCOPE( "PollEvents" );
+			SDL_Event e;
+			while( SDL_PollEvent( &e ) )
+			{
+				switch( e.type )
+				{
+					case SDL_QUIT:
+					{
+						input.push_back( InputEvent{ .frame = m_Frame, .type = InputType::Quit } );
+						break;
+					}
+
+					case SDL_KEYDOWN:
+					{
+						// dump profile
+						if( e.key.keysym.sym == SDLK_F12 && !e.key.repeat )
+						{
+							DRUI_PROFILE_WRITE( DRUI_PROFILE_TRACE_PATH );
+						}
+						break;
+					}
+
+					case SDL_MOUSEBUTTONDOWN:
+					case SDL_MOUSEBUTTONUP:
+					{
+						input.push_back( InputEvent
+							{
+								.frame = m_Frame,
+								.type = e.type == SDL_MOUSEBUTTONDOWN ? InputType::MouseDown : InputType::MouseUp,
+								.x = e.button.x,
+								.y = e.button.y,
+								.button = e.button.button
+							}
+						);
+						break;
+					}
+
+					case SDL_MOUSEMOTION:
+					{
+						input.push_back( InputEvent{ .frame = m_Frame, .type = InputType::MouseMove, .x = e.motion.x, .y = e.motion.y } );
+						break;
+					}
+
+					case SDL_MOUSEWHEEL:
+					{
+						input.push_back( InputEvent{ .frame = m_Frame, .type = InputType::Wheel, .wheel = e.wheel.y } );
+						break;
+					}
+				}
+			}
+		}
+
+		// record?
+		if( !options.recordPath.empty() )
+		{
+			recording.insert( recording.end(), input.cbegin(), input.cend() );
 		}
 
-		int mouseWheelDelta = 0;
+		Step( input );
+
+		// wait for next frame
+		{
+			DRUI_PROFILE_SCOPE( "Sleep" );
+			timer.Sleep();
+		}
+	}
+
+	OnStatePosted( nullptr );
+	DRUI_PROFILE_WRITE( DRUI_PROFILE_TRACE_PATH );
+
+	// save recording?
+	if( !options.recordPath.empty() )
+	{
+		SaveInputTrace( options.recordPath, recording );
+		Console::PrintLn( "Recorded {} input events over {} frames to '{}'.", recording.size(), m_Frame, options.recordPath );
+	}
+
+	// frame-time telemetry
+	timer.PrintStats();
+	if( !options.statsPath.empty() )
+	{
+		timer.WriteStats( options.statsPath );
+		Console::PrintLn( "Frame-time histograms saved to '{}'.", options.statsPath );
+	}
+}
+
+void Application::Start()
+{
+	// show Window
+	m_Gui.ShowWindow();
+	DRUI_PROFILE_THREAD( "ui" );
+
+	// init m_App
+	InitWidgetTree( m_App, NullKey );
+
+	// the HUD is a tree of its own, drawn over m_App; its layout never changes
+	if( m_Hud )
+	{
+		InitWidgetTree( m_Hud, NullKey );
+		SetRebuildLayoutTree();
+		RebuildLayoutTree( m_Hud );
+		SetRebuildLayoutTree();
+	}
+	SDL_GetMouseState( &m_MouseX, &m_MouseY );
+}
+
+FrameTimings Application::Step( std::span<InputEvent const> input )
+{
+	DRUI_PROFILE_SCOPE( "Frame" );
+
+	// phase stopwatch, and allocation counts
+	using Clock = std::chrono::steady_clock;
+	auto const frameStart = Clock::now();
+	auto const frameAllocs = AllocTracker::ThisThread();
+	auto lapStart = frameStart;
+	auto lapAllocs = frameAllocs;
+	auto lap = [ &lapStart, &lapAllocs ] ( double& ms, AllocTracker::Count& allocs )
+	{
+		auto now = Clock::now();
+		ms += std::chrono::duration<double, std::milli>( now - lapStart ).count();
+		lapStart = now;
+
+		auto allocsNow = AllocTracker::ThisThread();
+		allocs += allocsNow - lapAllocs;
+		lapAllocs = allocsNow;
+	};
+	FrameTimings timings;
+	if( m_RenderThread )
+	{
+		m_RenderThread->SetInputTime( frameStart );
+	}
 
-		SDL_Event e;
-		while( SDL_PollEvent( &e ) )
+	// rebuild?
+	if( ShouldRebuildLayoutTree() )
+	{
+		DRUI_PROFILE_SCOPE( "RebuildLayoutTree" );
+		RebuildLayoutTree( m_App );
+	}
+	lap( timings.layout, timings.allocations.layout );
+
+	// apply input
+	int mouseWheelDelta = 0;
+	for( auto const& event : input )
+	{
+		switch( event.type )
 		{
-			switch( e.type )
+			case InputType::Quit:
 			{
-				case SDL_QUIT:
-				{
-					finished = true;
-					break;
-				}
+				m_Finished = true;
+				break;
+			}
 
-				case SDL_MOUSEBUTTONDOWN:
-				case SDL_MOUSEBUTTONUP:
-				case SDL_MOUSEMOTION:
-				{
-					auto buttons = SDL_GetMouseState( &mouseX, &mouseY );
-					break;
-				}
+			case InputType::MouseDown:
+			case InputType::MouseUp:
+			case InputType::MouseMove:
+			{
+				m_MouseX = event.x;
+				m_MouseY = event.y;
+				break;
+			}
 
-				case SDL_MOUSEWHEEL:
-				{
-					mouseWheelDelta = e.wheel.y;
-					break;
-				}
+			case InputType::Wheel:
+			{
+				mouseWheelDelta = event.wheel;
+				break;
 			}
 		}
+	}
+	lap( timings.input, timings.allocations.input );
 
-		// compare new and old hit trees
-		auto const prevHitTree = GetHitTree();
+	// hit testing
+	{
+		DRUI_PROFILE_SCOPE( "HitTest" );
+		// compare new and old hit trees; changes go in the input lane,
+		// so they never wait behind a backlog. The old is kept in a member,
+		// reusing its capacity.
+		m_PrevHitTree.assign( GetHitTree().cbegin(), GetHitTree().cend() );
+		auto const& prevHitTree = m_PrevHitTree;
 		ClearHitTree();
-		RunHitTests( m_App, mouseX, mouseY );
+		RunHitTests( m_App, m_MouseX, m_MouseY );
 		auto const& currHitTree = GetHitTree();
 
 		// turn off widgets that have left the hit tree
@@ -79,7 +287,8 @@ void Application::Run()
 					[] ( WidgetState& widgetState )
 					{
 						widgetState.isInHitTree = false;
-					}
+					},
+					Lane::Input
 				);
 			}
 		}
@@ -93,14 +302,19 @@ void Application::Run()
 					[] ( WidgetState& widgetState )
 					{
 						widgetState.isInHitTree = true;
-					}
+					},
+					Lane::Input
 				);
 			}
 		}
 
-		// update hovered widget
+		// update hovered widget (forgetting one removed since)
+		if( m_PrevHovered && !WidgetExists( m_PrevHovered ) )
+		{
+			m_PrevHovered = NullKey;
+		}
 		auto hovered = currHitTree.size() ? currHitTree.back() : 0;
-		if( hovered != prev_hovered )
+		if( hovered != m_PrevHovered )
 		{
 			if( hovered )
 			{
@@ -108,21 +322,23 @@ void Application::Run()
 					[] ( WidgetState& widgetState )
 					{
 						widgetState.isHovered = true;
-					}
+					},
+					Lane::Input
 				);
 			}
 
-			if( prev_hovered )
+			if( m_PrevHovered )
 			{
-				SetState<WidgetState>( prev_hovered,
+				SetState<WidgetState>( m_PrevHovered,
 					[] ( WidgetState& widgetState )
 					{
 						widgetState.isHovered = false;
-					}
+					},
+					Lane::Input
 				);
 			}
 
-			prev_hovered = hovered;
+			m_PrevHovered = hovered;
 		}
 
 		// handle mouse wheel
@@ -137,32 +353,75 @@ void Application::Run()
 						[ mouseWheelDelta ] ( Transform& transform )
 						{
 							transform.y -= mouseWheelDelta * 10;
-						}
+						},
+						Lane::Input
 					);
 					break;
 				}
 			}
 		}
+	}
+	lap( timings.hitTest, timings.allocations.hitTest );
 
-		// update other things ...
-		
+	// update other things ...
+	if( m_Hud )
+	{
+		UpdatePerfHud( m_Hud );
+	}
 
-		// process changes
+	// process changes
+	{
+		DRUI_PROFILE_SCOPE( "FlushCallbacks" );
 		FlushCallbacks();
+	}
+	lap( timings.flush, timings.allocations.flush );
 
-		// rebuild?
-		if( ShouldRebuildLayoutTree() )
-		{
-			RebuildLayoutTree( m_App );
-		}
+	// rebuild?
+	if( ShouldRebuildLayoutTree() )
+	{
+		DRUI_PROFILE_SCOPE( "RebuildLayoutTree" );
+		RebuildLayoutTree( m_App );
+	}
+	lap( timings.layout, timings.allocations.layout );
 
-		// render
+	// render
+	{
+		DRUI_PROFILE_SCOPE( "RenderLayoutTree" );
 		Render::ClearScreen();
+
+		// the window is the outermost clip, culling whatever's off it
+		Render::PushClipRect( Layouts::Rect{ .w = m_Width, .h = m_Height } );
 		RenderLayoutTree( m_App );
+		if( m_Hud )
+		{
+			RenderLayoutTree( m_Hud );
+		}
+		Render::PopClipRect();
+	}
+	lap( timings.render, timings.allocations.render );
+	{
+		DRUI_PROFILE_SCOPE( "Present" );
 		Render::Present();
-
-		// wait for next frame
-		timer.Sleep();
 	}
+	lap( timings.present, timings.allocations.present );
+
+	// close the frame's counters
+	timings.total = std::chrono::duration<double, std::milli>( Clock::now() - frameStart ).count();
+	timings.latency = m_RenderThread ? m_RenderThread->LatencyMs() : timings.total;
+	timings.allocations.total = AllocTracker::ThisThread() - frameAllocs;
+	Counters::Increment( Counters::Allocations, timings.allocations.total.allocations );
+	Counters::Increment( Counters::AllocatedBytes, timings.allocations.total.bytes );
+	Counters::EndFrame( timings.total );
+	++m_Frame;
+	return timings;
+}
 
-}
\ No newline at end of file
+bool Application::Finished() const
+{
+	return m_Finished;
+}
+
+uint32_t Application::Frame() const
+{
+	return m_Frame;
+}
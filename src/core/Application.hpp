@@ -3,18 +3,102 @@
 #ifndef CORE_APPLICATION_HPP_INCLUDED
 #define CORE_APPLICATION_HPP_INCLUDED
 
+#include "core/AllocTracker.hpp"
 #include "core/GuiRuntime.hpp"
+#include "core/InputTrace.hpp"
 #include "core/Key.hpp"
+#include "core/Timer.hpp"
+
+#include<memory>
+#include<span>
+#include<string>
+#include<vector>
+
+class RenderThread;
+
+// heap allocations made in each phase of a frame, while AllocTracker is enabled
+struct FrameAllocations
+{
+  AllocTracker::Count input;
+  AllocTracker::Count hitTest;
+  AllocTracker::Count flush;
+  AllocTracker::Count layout;
+  AllocTracker::Count render;
+  AllocTracker::Count present;
+  AllocTracker::Count total;
+};
+
+// milliseconds spent in each phase of a frame
+struct FrameTimings
+{
+  double input   = 0.0;
+  double hitTest = 0.0;
+  double flush   = 0.0;
+  double layout  = 0.0;
+  double render  = 0.0;
+  double present = 0.0;
+  double total   = 0.0;
+
+  // input to present, of the latest frame presented (with a render thread, maybe an earlier one)
+  double latency = 0.0;
+
+  FrameAllocations allocations;
+};
+
+// how Run() paces and reports the interactive main loop
+struct RunOptions
+{
+  // if given, the session's input is saved here as an InputTrace on exit
+  std::string recordPath;
+
+  // VSync falls back to Fixed if the renderer can't do it
+  Pacing pacing = Pacing::Fixed;
+
+  // 0 for the display's refresh rate (or 60 if unknown)
+  int fps = 0;
+
+  // if given, frame-time histograms are saved here as csv on exit
+  std::string statsPath;
+};
 
 class Application
 {
 private:
   GuiRuntime m_Gui;
+  std::unique_ptr<RenderThread> m_RenderThread;
   Key        m_App;
+  Key        m_Hud = NullKey;
+  int        m_Width;
+  int        m_Height;
+  int        m_MouseX = 0;
+  int        m_MouseY = 0;
+  Key        m_PrevHovered = NullKey;
+  std::vector<Key> m_PrevHitTree;
+  bool       m_Finished = false;
+  uint32_t   m_Frame = 0;
 
 public:
-  Application( int w, int h, Key root );
-  void Run();
+  Application( int w, int h, Key root, bool headless = false );
+  ~Application();
+
+  // replay drawing on a render thread, which presents while the UI thread
+  // works on the next frame; call before Start() or Run(). Declined, saying so,
+  // if the backend can't be drawn with from another thread (e.g. OpenGL).
+  void UseRenderThread();
+
+  // overlay a PerfHud on the app's top half, updated every frame; call before Start() or Run()
+  void ShowPerfHud();
+
+  // interactive main loop; prints frame-time percentiles on exit
+  void Run( RunOptions const& options = {} );
+
+  // or drive frames directly, as fast as you like:
+  // Start() once, then Step() once per frame with that frame's input
+  void Start();
+  FrameTimings Step( std::span<InputEvent const> input );
+
+  bool Finished() const;
+  uint32_t Frame() const;
 };
 
-#endif
\ No newline at end of file
+#endif
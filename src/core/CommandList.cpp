@@ -0,0 +1,134 @@
+// CommandList.cpp
+
+#include "CommandList.hpp"
+#include "RenderBackend.hpp"
+
+#include<format>
+#include<stdexcept>
+
+void CommandList::Clear()
+{
+  m_Commands.clear();
+  m_Text.clear();
+}
+
+bool CommandList::Empty() const
+{
+  return m_Commands.empty();
+}
+
+void CommandList::Add( Command const& command )
+{
+  m_Commands.push_back( command );
+}
+
+void CommandList::AddText( Rect r, std::string_view s )
+{
+  auto const begin = static_cast<uint32_t>( m_Text.size() );
+  m_Text.append( s );
+  m_Commands.push_back( Command{ .op = Op::DrawText, .r = r, .textBegin = begin, .textEnd = static_cast<uint32_t>( m_Text.size() ) } );
+}
+
+void CommandList::Replay( RenderBackend& target, LayerMap& layers ) const
+{
+  auto layer = [ & ] ( LayerId id )
+  {
+    auto it = layers.find( id );
+    if( it == layers.end() )
+    {
+      throw std::runtime_error{ std::format( "CommandList::Replay() given unknown layer {}", id ) };
+    }
+    return it->second;
+  };
+
+  // reused between texts, as the backend wants a std::string
+  static thread_local std::string s_Text;
+
+  // a layer that couldn't be created (e.g. out of texture memory) is drawn as nothing
+  bool skipping = false;
+  for( auto const& command : m_Commands )
+  {
+    if( skipping && command.op != Op::EndLayer )
+    {
+      continue;
+    }
+
+    switch( command.op )
+    {
+      case Op::ClearScreen:    target.ClearScreen(); break;
+      case Op::Present:        target.Present(); break;
+      case Op::DrawRect:       target.DrawRect( command.r, command.colour ); break;
+      case Op::DrawFilledRect: target.DrawFilledRect( command.r, command.colour ); break;
+      case Op::DrawRoundedBox: target.DrawRoundedBox( command.r, command.value, command.colour ); break;
+      case Op::SetClipRect:    target.SetClipRect( command.r ); break;
+      case Op::ResetClipRect:  target.ResetClipRect(); break;
+      case Op::ClearLayerRect: target.ClearLayerRect( command.r ); break;
+
+      case Op::DrawText:
+      {
+        s_Text.assign( m_Text, command.textBegin, command.textEnd - command.textBegin );
+        target.DrawText( command.r, s_Text );
+        break;
+      }
+
+      case Op::CreateLayer:
+      {
+        layers.emplace( command.layer, target.CreateLayer( command.r.w, command.r.h ) );
+        break;
+      }
+
+      case Op::DestroyLayer:
+      {
+        if( auto destroyed = layer( command.layer ) )
+        {
+          target.DestroyLayer( destroyed );
+        }
+        layers.erase( command.layer );
+        break;
+      }
+
+      case Op::BeginLayer:
+      {
+        auto begun = layer( command.layer );
+        if( !begun )
+        {
+          skipping = true;
+          break;
+        }
+        target.BeginLayer( begun, command.r );
+        break;
+      }
+
+      case Op::EndLayer:
+      {
+        if( skipping )
+        {
+          skipping = false;
+          break;
+        }
+        target.EndLayer();
+        break;
+      }
+
+      case Op::DrawLayer:
+      {
+        if( auto drawn = layer( command.layer ) )
+        {
+          target.DrawLayer( drawn, command.src, command.r.x, command.r.y );
+        }
+        break;
+      }
+
+      case Op::ShiftLayer:
+      {
+        auto src = layer( command.layer );
+        auto dst = layer( command.dst );
+        if( src && dst )
+        {
+          target.ShiftLayer( src, dst, command.value );
+        }
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+// CommandList.hpp
+// one frame's draw commands: recorded on the UI thread, replayed on the render thread
+
+#ifndef CORE_COMMAND_LIST_HPP_INCLUDED
+#define CORE_COMMAND_LIST_HPP_INCLUDED
+
+#include "rgba32.hpp"
+
+#include<Layout/Layouts.hpp>
+
+#include<chrono>
+#include<cstdint>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<vector>
+
+class RenderBackend;
+
+class CommandList
+{
+public:
+  using Rect = Layouts::Rect;
+  using Clock = std::chrono::steady_clock;
+
+  // layers are recorded by id; the render thread maps ids to its backend's layers
+  using LayerId = uint32_t;
+  using LayerMap = std::unordered_map<LayerId, void*>;
+
+  enum class Op : uint8_t
+  {
+    ClearScreen,
+    Present,
+    DrawRect,
+    DrawFilledRect,
+    DrawRoundedBox,
+    DrawText,
+    SetClipRect,
+    ResetClipRect,
+    CreateLayer,
+    DestroyLayer,
+    BeginLayer,
+    EndLayer,
+    ClearLayerRect,
+    DrawLayer,
+    ShiftLayer
+  };
+
+  struct Command
+  {
+    Op op;
+    Rect r{};             // CreateLayer: size; BeginLayer: origin; DrawLayer: (x, y)
+    Rect src{};           // DrawLayer
+    rgba32 colour{};
+    int value = 0;        // DrawRoundedBox: radius; ShiftLayer: dy
+    LayerId layer = 0;
+    LayerId dst = 0;      // ShiftLayer
+    uint32_t textBegin = 0;
+    uint32_t textEnd = 0;
+  };
+
+private:
+  std::vector<Command> m_Commands;
+  std::string m_Text;   // DrawText's strings, back to back
+
+public:
+  // when the frame's input was gathered, for measuring input-to-present latency
+  Clock::time_point inputTime;
+
+  // keeps capacity, for recycling
+  void Clear();
+  bool Empty() const;
+
+  void Add( Command const& command );
+  void AddText( Rect r, std::string_view s );
+
+  // onto 'target', creating and destroying its layers in 'layers'; throws on unknown layers.
+  // Layers the target fails to create are drawn as nothing.
+  void Replay( RenderBackend& target, LayerMap& layers ) const;
+};
+
+#endif
@@ -0,0 +1,139 @@
+// Counters.cpp
+
+#include "Counters.hpp"
+
+#include<algorithm>
+#include<array>
+#include<atomic>
+#include<cmath>
+
+namespace Counters
+{
+  struct Frame
+  {
+    std::array<uint64_t, NumCounters> counts{};
+    double ms = 0.0;
+  };
+
+  static std::array<std::atomic<uint64_t>, NumCounters> s_ThisFrame{};
+  static std::array<Frame, s_HistorySize> s_History;   // ring buffer
+  static int s_NumFrames = 0;                           // total frames archived
+
+  static constexpr std::array<std::string_view, NumCounters> s_Names =
+  {
+    "SetState",
+    "PostState",
+    "observers",
+    "flush iterations",
+    "callbacks deferred",
+    "layout nodes",
+    "text measured",
+    "draw calls",
+    "geometry batches",
+    "glyphs",
+    "layer blits",
+    "layers drawn",
+    "hit-test nodes",
+    "draws culled",
+    "widgets culled",
+    "allocations",
+    "bytes allocated",
+  };
+
+  void Increment( Counter counter, uint64_t amount )
+  {
+    s_ThisFrame[ counter ].fetch_add( amount, std::memory_order_relaxed );
+  }
+
+  uint64_t ThisFrame( Counter counter )
+  {
+    return s_ThisFrame[ counter ].load( std::memory_order_relaxed );
+  }
+
+  void EndFrame( double frameMs )
+  {
+    auto& frame = s_History[ s_NumFrames % s_HistorySize ];
+    for( auto i = 0; i < NumCounters; ++i )
+    {
+      frame.counts[ i ] = s_ThisFrame[ i ].exchange( 0, std::memory_order_relaxed );
+    }
+    frame.ms = frameMs;
+    ++s_NumFrames;
+  }
+
+  uint64_t LastFrame( Counter counter )
+  {
+    // early exit: no history
+    if( s_NumFrames == 0 )
+    {
+      return 0;
+    }
+    return s_History[ ( s_NumFrames - 1 ) % s_HistorySize ].counts[ counter ];
+  }
+
+  int NumFrames()
+  {
+    return std::min( s_NumFrames, s_HistorySize );
+  }
+
+  double Average( Counter counter )
+  {
+    // early exit: no history
+    auto const n = NumFrames();
+    if( n == 0 )
+    {
+      return 0.0;
+    }
+
+    uint64_t sum = 0;
+    for( auto i = 0; i < n; ++i )
+    {
+      sum += s_History[ i ].counts[ counter ];
+    }
+    return static_cast<double>( sum ) / n;
+  }
+
+  double AverageFrameMs()
+  {
+    // early exit: no history
+    auto const n = NumFrames();
+    if( n == 0 )
+    {
+      return 0.0;
+    }
+
+    auto sum = 0.0;
+    for( auto i = 0; i < n; ++i )
+    {
+      sum += s_History[ i ].ms;
+    }
+    return sum / n;
+  }
+
+  double FrameMsPercentile( double percent )
+  {
+    // early exit: no history
+    auto const n = NumFrames();
+    if( n == 0 )
+    {
+      return 0.0;
+    }
+
+    // nearest rank
+    std::array<double, s_HistorySize> ms;
+    for( auto i = 0; i < n; ++i )
+    {
+      ms[ i ] = s_History[ i ].ms;
+    }
+    auto rank = static_cast<int>( std::ceil( std::clamp( percent, 0.0, 100.0 ) / 100.0 * n ) );
+    rank = std::clamp( rank, 1, n );
+    std::nth_element( ms.begin(), ms.begin() + rank - 1, ms.begin() + n );
+    return ms[ rank - 1 ];
+  }
+
+  std::string_view Name( Counter counter )
+  {
+    return s_Names.at( counter );
+  }
+
+} // namespace Counters
@@ -0,0 +1,63 @@
+// Counters.hpp
+// per-frame engine counters, with a rolling history of recent frames
+//
+// Any thread may call Increment(), e.g. the render thread's draws count towards
+// the UI thread's current frame. The rest is UI thread only.
+
+#ifndef CORE_COUNTERS_HPP_INCLUDED
+#define CORE_COUNTERS_HPP_INCLUDED
+
+#include<cstdint>
+#include<string_view>
+
+namespace Counters
+{
+  enum Counter
+  {
+    SetStateCalls,
+    PostStateCalls,
+    ObserverCallbacks,
+    FlushIterations,
+    DeferredCallbacks,
+    LayoutNodesBuilt,
+    TextMeasurements,
+    DrawCalls,
+    GeometryBatches,
+    GlyphsDrawn,
+    LayerBlits,
+    LayersDrawn,
+    HitTestNodes,
+    CulledDraws,
+    CulledWidgets,
+    Allocations,      // the UI thread's, while AllocTracker is enabled
+    AllocatedBytes,
+
+    NumCounters
+  };
+
+  // frames kept for averages and percentiles
+  static constexpr int s_HistorySize = 120;
+
+  void Increment( Counter counter, uint64_t amount = 1 );
+
+  // the current (unfinished) frame
+  uint64_t ThisFrame( Counter counter );
+
+  // archive the current frame and start a new one.
+  // 'frameMs' is the time spent working on the frame (i.e. excluding any sleep)
+  void EndFrame( double frameMs );
+
+  // the latest archived frame
+  uint64_t LastFrame( Counter counter );
+
+  // over the archived frames
+  int NumFrames();
+  double Average( Counter counter );
+  double AverageFrameMs();
+  double FrameMsPercentile( double percent );
+
+  std::string_view Name( Counter counter );
+
+} // namespace Counters
+
+#endif
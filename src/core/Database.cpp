@@ -1,88 +1,173 @@
 // Database.cpp
 
+#include<algorithm>
 #include<functional>
 #include<map>
-#include<tuple>
 #include<array>
 #include<vector>
-#include<queue>
+#include<optional>
 #include<string>
+#include<string_view>
 #include<set>
+#include<unordered_map>
+#include<unordered_set>
+#include<atomic>
+#include<chrono>
+#include<exception>
+#include<mutex>
+#include<stop_token>
 
 #include<iostream>
 #include<format>
 
 #include "core/Database.hpp"
+#include "core/Counters.hpp"
+#include "core/MpscQueue.hpp"
+#include "core/Profiler.hpp"
+#include "core/Render.hpp"
+#include "core/SlotMap.hpp"
+#include "core/TextLayout.hpp"
+#include "core/ThreadPool.hpp"
 
 using namespace Layouts;
 
-////////////////////////////////////
-// TEMPLATE METAPROGRAMMING STUFF //
-////////////////////////////////////
+////////////////////
+// DATABASE STUFF //
+////////////////////
 
-// https://stackoverflow.com/questions/26169198/how-to-get-the-index-of-a-type-in-a-variadic-type-pack
+// the smallest rect covering both
+static Rect unite( Rect a, Rect b )
+{
+	auto const x = std::min( a.x, b.x );
+	auto const y = std::min( a.y, b.y );
+	return Rect
+	{
+		.x = x,
+		.y = y,
+		.w = std::max( a.x + a.w, b.x + b.w ) - x,
+		.h = std::max( a.y + a.h, b.y + b.h ) - y
+	};
+}
 
-template <typename T, typename ... Ts>
-struct Index;
+// patience sorting, O(n log n)
+static size_t longestIncreasingSubsequence( std::vector<size_t> const& values )
+{
+	std::vector<size_t> tails;   // the smallest tail of each length so far
+	for( auto const value : values )
+	{
+		auto it = std::lower_bound( tails.begin(), tails.end(), value );
+		if( it == tails.end() )
+		{
+			tails.push_back( value );
+		}
+		else
+		{
+			*it = value;
+		}
+	}
+	return tails.size();
+}
 
-template <typename T, typename ... Ts>
-struct Index<T, T, Ts ...> : std::integral_constant<std::size_t, 0> {};
+class Database
+{
+private:
+	// room for a StateMethod, plus where (and to which incarnation) it applies
+	using PureMethod = InplaceFunction< void(), 120 >;
+	using Clock = std::chrono::steady_clock;
 
-template <typename T, typename U, typename... Ts>
-struct Index<T, U, Ts ...> : std::integral_constant<std::size_t, 1 + Index<T, Ts ...>::value> {};
+	// 'depth' counts the observer hops from an outside change, to catch cycles
+	struct Callback
+	{
+		PureMethod method;
+		uint32_t depth = 0;
+	};
 
-template <typename T, typename... Ts>
-constexpr std::size_t IndexOf = Index<T, Ts...>::value;
+	// first in, first out, keeping its capacity (unlike std::queue's deque),
+	// so a steady stream of callbacks doesn't allocate
+	class CallbackQueue
+	{
+	private:
+		std::vector<Callback> m_Callbacks;
+		size_t m_Front = 0;
 
+	public:
+		void push( Callback callback )
+		{
+			// reclaim the popped before growing
+			if( m_Front && m_Callbacks.size() == m_Callbacks.capacity() )
+			{
+				m_Callbacks.erase( m_Callbacks.begin(), m_Callbacks.begin() + m_Front );
+				m_Front = 0;
+			}
+			m_Callbacks.push_back( std::move( callback ) );
+		}
 
-////////////////////
-// DATABASE STUFF //
-////////////////////
+		Callback pop()
+		{
+			auto callback = std::move( m_Callbacks.at( m_Front++ ) );
+			if( m_Front == m_Callbacks.size() )
+			{
+				m_Callbacks.clear();
+				m_Front = 0;
+			}
+			return callback;
+		}
 
-template<typename State>
-using ObserverMethod = std::function< void( Key observer, State const& )>;
+		bool empty() const
+		{
+			return m_Front == m_Callbacks.size();
+		}
 
-template<typename State>
-class ObserverRegistry
-{
-public:
-	struct ObserverEntry
+		size_t size() const
+		{
+			return m_Callbacks.size() - m_Front;
+		}
+	};
+
+	struct DirtyMark
 	{
-		Key observer;
-		ObserverMethod<State> callback;
+		Lane lane = Lane::Normal;
+		uint32_t depth = 0;
 	};
 
-private:
-	std::map<Key, std::vector<ObserverEntry>> m_Registry;
+	static constexpr uint32_t s_MaxObserverDepth = 100;
 
-public:
-	template<typename State>
-	void Add( Key observer, Key observed, ObserverMethod<State> callback )
+	// a state's sets, oldest first, whichever lanes they're queued in
+	struct PendingSets
 	{
-		m_Registry[ observed ].push_back( ObserverEntry{ .observer = observer, .callback = callback } );
-	}
+		std::vector<StateMethod> applies;
+		uint64_t numQueued = 0;   // ever, so the first pending is number numQueued - applies.size() + 1
+	};
 
-	bool Exists( Key observed ) const
+	struct ObserverEntry
 	{
-		return m_Registry.contains( observed );
-	}
+		Key observer;
+		StateMethod callback;
+		uint64_t serial;   // as in its handle
+	};
 
-	std::vector<ObserverEntry> const& Get( Key observed ) const
+	// a state's observers, and whether they're due to be told of a change
+	struct Observers
 	{
-		return m_Registry.at( observed );
-	}
-};
-
-template<typename State>
-using SetStateMethod  = std::function< void( State& ) >;
+		SlotMap<ObserverEntry> entries;
+		std::optional<DirtyMark> dirty;
+	};
 
-using WidgetPredicate = std::function< bool( Key ) >;
+	// a state as a computed state read it
+	struct Dependency
+	{
+		StateId id;
+		uint64_t version;
+	};
 
-template<typename ... States>
-class Database
-{
-private:
-	using PureMethod = std::function< void() >;
+	struct ComputedState
+	{
+		InplaceFunction< bool(), 112 > recompute;   // true if the result changed
+		std::vector<Dependency> dependencies;
+		std::optional<Lane> maybeStale;   // something it read has changed
+		bool isFresh = false;
+		bool isComputing = false;
+	};
 
 private:
 	// set during app (incl. widget) initialisation
@@ -90,24 +175,52 @@ private:
 	// not accessed by widgets or their lambdas
 	std::map<Key, Widget> m_WidgetRegistry;
 	std::map<std::string, Key> m_TagRegistry;
-	std::tuple<ObserverRegistry<States>...> m_ObserverRegistries;
+	std::map<StateId, Observers> m_Observers;
+	std::map<Key, std::vector<ObserverHandle>> m_Subscriptions;   // by observer
+	uint64_t m_NextObserverSerial = 1;
 	
 	// changes depending on user interaction
-	// only m_States can be accessed by widgets and their lambdas
-	// (via 'this')
-	std::tuple<std::map<Key, States>...> m_States;
+	// only the stores' states can be accessed by widgets and their lambdas
+	// (via the state templates)
+	std::vector<std::unique_ptr<StateStoreBase>> m_Stores;   // by type id
 	bool m_RebuildLayout = true;
 	std::vector<Key> m_HitTree;
 
 	// internal data, not accessed by widgets or their lambdas
-	std::set<Key> m_Dirty;
-	std::array<std::set<Key>, sizeof...( States ) > m_DirtyByState;
-	std::queue<PureMethod> m_Callbacks;
+	std::vector<StateId> m_Dirty;   // marked in m_Observers
+	std::map<StateId, PendingSets> m_PendingSets;   // kept while the widget lives, reusing their capacity
+	std::array<CallbackQueue, static_cast<size_t>( Lane::NumLanes )> m_Callbacks;
+	Lane m_CurrentLane = Lane::Idle;
+	uint32_t m_CurrentDepth = 0;
+	double m_FlushBudgetMs = 4.0;
+
+	// the only members other threads may touch, via PostState()
+	MpscQueue<PureMethod> m_Posted;
+	std::atomic<bool> m_WakePending = false;
+	std::mutex m_WakeMutex;
+	PureMethod m_Wake;
+
+	// UI thread only: cancels each owner's async tasks
+	std::map<Key, std::stop_source> m_AsyncOwners;
+
+	// computed states, and which states they read. Versions are kept only
+	// for states with readers.
+	std::map<StateId, ComputedState> m_Computed;
+	std::map<StateId, std::set<StateId>> m_Readers;
+	std::map<StateId, uint64_t> m_Versions;
+	std::vector<StateId> m_MaybeStale;   // marked in m_Computed
+	std::vector<Dependency>* m_Reads = nullptr;
+	std::vector<std::vector<Dependency>> m_SpareReads;   // recycled dependency lists
+
+	// recycled subtrees, by signature: detached, reset, and ready to initialise
+	std::unordered_map<std::string, std::vector<Key>> m_WidgetPool;
+	size_t m_WidgetPoolLimit = 256;
 	
 public:
 	Key CreateWidget(
 		std::string const& tag,
 		InitStateMethod initMethod,
+		InitStateMethod extraInitMethod,
 		BuildLayoutMethod build,
 		HitTestMethod hitTest,
 		RenderWidgetMethod renderWidget,
@@ -120,6 +233,7 @@ public:
 				.tag = tag,
 				.self = key,
 				.initState = initMethod,
+				.extraInitState = extraInitMethod,
 				.buildLayout = build,
 				.runHitTest = hitTest,
 				.renderWidget = renderWidget,
@@ -144,17 +258,146 @@ public:
 	{
 		auto& child =  m_WidgetRegistry.at( childNode );
 		child.parent = parentNode;
+		child.isPooled = false;
 		child.initState( childNode );
+		if( child.extraInitState )
+		{
+			child.extraInitState( childNode );
+		}
 		for( auto const widget : child.children )
 		{
 			InitWidgetTree( widget, childNode );
 		}
+
+		// only now: children it made in its own init were initialised just above
+		child.isInitialised = true;
+	}
+
+	ChildChanges SetChildren( Key parent, std::vector<ChildDescriptor> const& descriptors )
+	{
+		// NB: map nodes don't move, so this stays valid as widgets are made
+		auto& children = m_WidgetRegistry.at( parent ).children;
+
+		// the current children, by key
+		std::unordered_map<std::string_view, size_t> currentByKey;
+		currentByKey.reserve( children.size() );
+		for( size_t i = 0; i < children.size(); ++i )
+		{
+			auto const& key = m_WidgetRegistry.at( children.at( i ) ).childKey;
+			if( key.size() )
+			{
+				currentByKey.try_emplace( key, i );
+			}
+		}
+
+		// match each described child to a current one, or make it (from the pool if
+		// it can be initialised here)
+		auto const isInitialised = m_WidgetRegistry.at( parent ).isInitialised;
+		ChildChanges changes;
+		std::vector<Key> newChildren;
+		newChildren.reserve( descriptors.size() );
+		std::vector<bool> isMade;
+		isMade.reserve( descriptors.size() );
+		std::vector<bool> isRecycled;
+		isRecycled.reserve( descriptors.size() );
+		std::vector<size_t> keptFrom;   // current indices, in the new order
+		std::vector<bool> isKept( children.size(), false );
+		std::unordered_set<std::string_view> seen;
+		seen.reserve( descriptors.size() );
+		try
+		{
+			for( auto const& descriptor : descriptors )
+			{
+				if( descriptor.key.size() && !seen.insert( descriptor.key ).second )
+				{
+					throw std::runtime_error{ std::format( "SetChildren(): widget {} ('{}') given key '{}' twice",
+						parent, m_WidgetRegistry.at( parent ).tag, descriptor.key ) };
+				}
+
+				auto it = descriptor.key.size() ? currentByKey.find( descriptor.key ) : currentByKey.end();
+				if( it != currentByKey.end() )
+				{
+					newChildren.push_back( children.at( it->second ) );
+					isMade.push_back( false );
+					isRecycled.push_back( false );
+					keptFrom.push_back( it->second );
+					isKept.at( it->second ) = true;
+					continue;
+				}
+
+				auto const recycled = isInitialised ? takeFromPool( descriptor.signature ) : NullKey;
+				auto const child = recycled != NullKey ? recycled : descriptor.create();
+				auto& widget = m_WidgetRegistry.at( child );
+				widget.parent = parent;
+				widget.childKey = descriptor.key;
+				widget.signature = descriptor.signature;
+				newChildren.push_back( child );
+				isMade.push_back( true );
+				isRecycled.push_back( recycled != NullKey );
+				++changes.created;
+				changes.recycled += recycled != NullKey;
+			}
+		}
+		catch( ... )
+		{
+			// undo: the made ones were never attached
+			for( size_t i = 0; i < newChildren.size(); ++i )
+			{
+				if( isMade.at( i ) )
+				{
+					destroySubtree( newChildren.at( i ) );
+				}
+			}
+			throw;
+		}
+
+		// destroy (or pool) the unmatched
+		for( size_t i = 0; i < children.size(); ++i )
+		{
+			if( !isKept.at( i ) )
+			{
+				invalidateLayers( children.at( i ), GetRect( children.at( i ) ) );
+				changes.pooled += recycleOrDestroy( children.at( i ) );
+				++changes.destroyed;
+			}
+		}
+
+		// those in increasing order stay put; the rest move
+		changes.kept = keptFrom.size();
+		changes.moved = changes.kept - longestIncreasingSubsequence( keptFrom );
+		children = std::move( newChildren );
+
+		// made children are initialised along with their parent if it isn't yet;
+		// recycled ones were made with other props
+		for( size_t i = 0; i < descriptors.size(); ++i )
+		{
+			if( isMade.at( i ) && isInitialised )
+			{
+				InitWidgetTree( children.at( i ), parent );
+			}
+			if( ( !isMade.at( i ) || isRecycled.at( i ) ) && descriptors.at( i ).update )
+			{
+				descriptors.at( i ).update( children.at( i ) );
+			}
+		}
+
+		// the same list lays out the same
+		if( changes.created || changes.destroyed || changes.moved )
+		{
+			m_RebuildLayout = true;
+		}
+		return changes;
 	}
 
 	LayoutBuilder BuildLayoutTree( Key root )
 	{
+		Counters::Increment( Counters::LayoutNodesBuilt );
 		auto const& widget = m_WidgetRegistry.at( root );
-		auto layout = widget.buildLayout( root );
+		auto layout = [ & ]
+		{
+			DRUI_PROFILE_WIDGET_SCOPE( "BuildLayout", root );
+			return widget.buildLayout( root );
+		}();
 		layout.SetKey( root );
 		for( auto const child : widget.children )
 		{
@@ -175,8 +418,20 @@ public:
 			return;
 		}
 
+		// early return: widget (and so its subtree) is outside the visible rect,
+		// i.e. the window or the current clip
+		if( widget.isCullable && !Render::IsVisible( rect ) )
+		{
+			Counters::Increment( Counters::CulledWidgets );
+			return;
+		}
+
 		// proceed with render
-		auto renderChildren = widget.renderWidget( root, rect );
+		auto renderChildren = [ & ]
+		{
+			DRUI_PROFILE_WIDGET_SCOPE( "RenderWidget", root );
+			return widget.renderWidget( root, rect );
+		}();
 
 		// early exit: not rendering children
 		if( !renderChildren )
@@ -191,6 +446,11 @@ public:
 		}
 	}
 
+	void DisableCulling( Key widget )
+	{
+		m_WidgetRegistry.at( widget ).isCullable = false;
+	}
+
 	void SetRebuildLayoutTree()
 	{
 		m_RebuildLayout = true;
@@ -209,14 +469,34 @@ public:
 		}
 
 		// rebuild tree
-		auto tree = BuildLayoutTree( root );
-		tree.DimChildren();
-		tree.PosChildren( 0, 0 );
+		auto tree = [ & ]
+		{
+			DRUI_PROFILE_SCOPE( "BuildLayoutTree" );
+			return BuildLayoutTree( root );
+		}();
+		{
+			DRUI_PROFILE_SCOPE( "DimWidths" );
+			tree.DimWidths();
+		}
+		{
+			// height-for-width text, measured in parallel
+			DRUI_PROFILE_SCOPE( "MeasureText" );
+			TextLayout::MeasureQueued();
+		}
+		{
+			DRUI_PROFILE_SCOPE( "DimHeights" );
+			tree.DimHeights();
+		}
+		{
+			DRUI_PROFILE_SCOPE( "PosChildren" );
+			tree.PosChildren( 0, 0 );
+		}
 		// tree.DebugPrint();
 
 		// push changes to widget tree
 		pushLayouts( tree.GetWidthBuilder(), tree.GetHeightBuilder() );
 
+		DRUI_PROFILE_SCOPE( "FlushCallbacks" );
 		FlushCallbacks();
 		m_RebuildLayout = false;
 	}
@@ -231,6 +511,13 @@ public:
 		m_HitTree.clear();
 	}
 
+	// pooled widgets are kept, but not to be used
+	bool WidgetExists( Key widget ) const
+	{
+		auto it = m_WidgetRegistry.find( widget );
+		return it != m_WidgetRegistry.end() && !it->second.isPooled;
+	}
+
 	bool TrueOfAny( Key root, WidgetPredicate predicate )
 	{
 		if( predicate( root ) )
@@ -288,137 +575,761 @@ public:
 		return m_WidgetRegistry.at( parent ).children;
 	}
 
-	template<typename State>
-	void CreateState( Key widget, State state, bool markAsDirty = false )
+	StateStoreBase& RegisterStateStore( std::unique_ptr<StateStoreBase> store )
+	{
+		store->type = m_Stores.size();
+		return *m_Stores.emplace_back( std::move( store ) );
+	}
+
+	// from creation, so observers added later in initialisation are told too
+	void MarkDirty( StateId id )
 	{
-		std::get<std::map<Key, State>>( m_States ).insert( { widget, state } );
-		if( markAsDirty )
+		m_Observers.try_emplace( id );
+		addDirty( id, Lane::Normal );
+	}
+
+	bool IsComputing() const
+	{
+		return m_Reads;
+	}
+
+	// bring a computed state up to date, and note what a computation reads
+	void NoteRead( StateId id )
+	{
+		if( m_Computed.contains( id ) )
+		{
+			refresh( id );
+		}
+		if( m_Reads )
 		{
-			m_Dirty.insert( widget );
-			m_DirtyByState.at( IndexOf<State, States...> ).insert( widget );
+			m_Reads->push_back( Dependency{ .id = id, .version = version( id ) } );
 		}
 	}
 
-	template<typename State>
-	State const& GetState( Key widget ) const
+	void Compute( StateId id, InplaceFunction< bool(), 80 > recompute )
 	{
-		if( !HasState<State>( widget ) )
+		m_Computed.insert_or_assign( id, ComputedState
+			{
+				.recompute = [ this, id, recompute ] () -> bool
+				{
+					// early exit: no change, so nothing to tell
+					if( !recompute() )
+					{
+						return false;
+					}
+					addDirty( id, std::min( Lane::Normal, m_CurrentLane ) );
+					invalidateLayers( id.widget, GetRect( id.widget ) );
+					return true;
+				}
+			}
+		);
+	}
+
+	ObserverHandle Observe( Key observer, StateId observed, StateMethod callback )
+	{
+		auto const serial = m_NextObserverSerial++;
+		auto const handle = ObserverHandle
+		{
+			.observed = observed,
+			.slot = m_Observers[ observed ].entries.Insert( ObserverEntry{ .observer = observer, .callback = callback, .serial = serial } ),
+			.serial = serial
+		};
+		m_Subscriptions[ observer ].push_back( handle );
+		return handle;
+	}
+
+	void Unsubscribe( ObserverHandle handle )
+	{
+		// early exit: already gone
+		auto const entry = findObserver( handle );
+		if( !entry )
+		{
+			return;
+		}
+
+		auto const observer = entry->observer;
+		auto it = m_Observers.find( handle.observed );
+		it->second.entries.Erase( handle.slot );
+		if( it->second.entries.Empty() )
 		{
-			throw std::runtime_error{ std::format( "Widget {} does not have {}", widget, State::AsString ) };
+			m_Observers.erase( it );
+		}
+
+		// in no particular order, so the last can fill the hole
+		auto subscriptions = m_Subscriptions.find( observer );
+		auto& handles = subscriptions->second;
+		auto const gone = std::ranges::find_if( handles, [ & ] ( ObserverHandle const& h ) { return h.serial == handle.serial; } );
+		*gone = handles.back();
+		handles.pop_back();
+		if( subscriptions->second.empty() )
+		{
+			m_Subscriptions.erase( subscriptions );
 		}
-		return std::get<std::map<Key, State>>( m_States ).at( widget );
 	}
 
-	template<typename State>
-	State const& ObserveState( Key observer, Key observed, ObserverMethod<State> callback )
+	void DestroyWidget( Key widget )
 	{
-		std::get<ObserverRegistry<State>>( m_ObserverRegistries ).Add( observer, observed, callback );
-		return GetState<State>( observed );
+		// early exit: already gone
+		if( !m_WidgetRegistry.contains( widget ) )
+		{
+			return;
+		}
+
+		// its area no longer draws anything
+		invalidateLayers( widget, GetRect( widget ) );
+		auto const parent = m_WidgetRegistry.at( widget ).parent;
+		if( parent != NullKey )
+		{
+			std::erase( m_WidgetRegistry.at( parent ).children, widget );
+		}
+		destroySubtree( widget );
+		m_RebuildLayout = true;
 	}
 
-	template<typename State>
-	State const& ObserveState( Key observer, std::string const& tag, ObserverMethod<State> callback )
+	void Set( StateId id, StateMethod apply, Lane lane )
 	{
-		// throw on unknown tag
-		if( !m_TagRegistry.contains( tag ) )
+		Counters::Increment( Counters::SetStateCalls );
+
+		// early exit: destroyed, so nothing to set
+		if( !WidgetExists( id.widget ) )
 		{
-			throw std::runtime_error{ std::format( "Unknown tag: '{}'", tag ) };
+			return;
 		}
-		Key observed = m_TagRegistry.at( tag );
-		std::get<ObserverRegistry<State>>( m_ObserverRegistries ).Add( observer, observed, callback );
-		return GetState<State>( observed );
+
+		lane = std::min( lane, m_CurrentLane );
+		auto const incarnation = incarnationOf( id.widget );
+		auto& pending = m_PendingSets[ id ];
+		pending.applies.push_back( std::move( apply ) );
+		auto const number = ++pending.numQueued;
+		callbacks( lane ).push( Callback
+			{
+				[ this, id, incarnation, number ] ()
+				{
+					// early exit: destroyed or recycled since
+					if( incarnationOf( id.widget ) != incarnation )
+					{
+						return;
+					}
+					applyPending( id, number );
+				},
+				m_CurrentDepth
+			}
+		);
 	}
 
-	template<typename State>
-	void SetState( Key widget, SetStateMethod<State> setState )
+	// any thread: queue for the next FlushCallbacks()
+	void Post( StateMethod set )
 	{
-		m_Callbacks.push( [=] () { setState( getState<State>( widget ) ); } );
-		addDirty<State>( widget );
+		Counters::Increment( Counters::PostStateCalls );
+		post( std::move( set ) );
 	}
 
-	template<typename State>
-	bool HasState( Key widget ) const
+	void SetFlushBudget( double ms )
 	{
-		return std::get<std::map<Key, State>>( m_States ).contains( widget );
+		m_FlushBudgetMs = ms;
+	}
+
+	void SetWidgetPoolLimit( size_t limit )
+	{
+		m_WidgetPoolLimit = limit;
+		for( auto& [ signature, pool ] : m_WidgetPool )
+		{
+			while( pool.size() > limit )
+			{
+				destroySubtree( pool.back() );
+				pool.pop_back();
+			}
+		}
+	}
+
+	bool RunAsync( Key owner, AsyncTask task )
+	{
+		auto const stop = m_AsyncOwners[ owner ].get_token();
+		return WorkerPool().TryPush( [ this, stop, task ] ()
+			{
+				// early exit: cancelled while queued
+				if( stop.stop_requested() )
+				{
+					return;
+				}
+
+				// failures are rethrown on the UI thread
+				std::function< void() > onComplete;
+				try
+				{
+					onComplete = task( stop );
+				}
+				catch( ... )
+				{
+					onComplete = [ error = std::current_exception() ] () { std::rethrow_exception( error ); };
+				}
+
+				post( [ stop, onComplete ] ()
+					{
+						if( !stop.stop_requested() && onComplete )
+						{
+							onComplete();
+						}
+					}
+				);
+			}
+		);
+	}
+
+	void CancelAsync( Key owner )
+	{
+		auto it = m_AsyncOwners.find( owner );
+		if( it != m_AsyncOwners.end() )
+		{
+			it->second.request_stop();
+			m_AsyncOwners.erase( it );
+		}
+	}
+
+	void OnStatePosted( PureMethod wake )
+	{
+		std::scoped_lock lock{ m_WakeMutex };
+		m_Wake = wake;
 	}
 
 	void FlushCallbacks()
 	{
+		// apply what other threads have posted, as if set here
+		m_WakePending.store( false );
+		PureMethod posted;
+		while( m_Posted.Pop( posted ) )
+		{
+			posted();
+		}
+
+		auto const deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double, std::milli>( m_FlushBudgetMs ) );
+		auto& input = callbacks( Lane::Input );
+		auto& normal = callbacks( Lane::Normal );
+		auto& idle = callbacks( Lane::Idle );
+
 		// Console::Print( "\nFlush" );
 		// int iteration = 0;
 		do
 		{
 			// Console::Print( "\n\n\nIteration {}, {} dirty widgets, {} callbacks.", iteration, m_Dirty.size(), m_Callbacks.size() );
+			Counters::Increment( Counters::FlushIterations );
+
+			// bring observed computed states up to date; those that change are dirtied
+			refreshStale();
 
-			// schedule dirty widgets to be observed
-			for( auto widget : m_Dirty )
+			// schedule dirty states' observers
+			for( auto const id : m_Dirty )
 			{
-				( runObservers<States>( widget ), ... );
+				runObservers( id );
 			}
 			m_Dirty.clear();
 
 			// Console::Print( "\n\n\t{} callbacks.", m_Callbacks.size() );
 		
-			// drain the callbacks
-			while( !m_Callbacks.empty() )
+			// drain the input lane regardless
+			while( !input.empty() )
 			{
-				m_Callbacks.front()();
-				m_Callbacks.pop();
+				runCallback( Lane::Input );
+			}
+
+			// then the others while there's time, idle only once normal is done
+			while( Clock::now() < deadline && !( normal.empty() && idle.empty() ) )
+			{
+				runCallback( normal.empty() ? Lane::Idle : Lane::Normal );
 			}
 			// iteration++;
-		} while( m_Dirty.size() );
+		} while( m_Dirty.size() || input.size() || m_MaybeStale.size() );
+
+		// carried over to the next flush
+		Counters::Increment( Counters::DeferredCallbacks, normal.size() + idle.size() );
 	}
 
 private:
-	template<typename State>
-	State& getState( Key widget )
+	// any thread: queue for the next FlushCallbacks()
+	void post( PureMethod method )
+	{
+		m_Posted.Push( std::move( method ) );
+
+		// wake once per flush, not once per post
+		if( !m_WakePending.exchange( true ) )
+		{
+			std::scoped_lock lock{ m_WakeMutex };
+			if( m_Wake )
+			{
+				m_Wake();
+			}
+		}
+	}
+
+	uint64_t version( StateId id ) const
 	{
-		if( !HasState<State>( widget ) )
+		auto it = m_Versions.find( id );
+		return it != m_Versions.end() ? it->second : 0;
+	}
+
+	// only states something reads need telling
+	void stateChanged( StateId id )
+	{
+		if( m_Readers.contains( id ) )
 		{
-			throw std::runtime_error{ std::format( "Widget {} does not have {}", widget, State::AsString ) };
+			++m_Versions[ id ];
+			markReadersStale( id, m_CurrentLane );
 		}
-		return std::get<std::map<Key, State>>( m_States ).at( widget );
 	}
 
-	template<typename State>
-	void addDirty( Key widget )
+	// readers of readers too, as an observed computed state may depend on an unobserved one
+	void markReadersStale( StateId id, Lane lane )
 	{
-		if( std::get<ObserverRegistry<State>>( m_ObserverRegistries ).Exists( widget ) )
+		auto it = m_Readers.find( id );
+		if( it == m_Readers.end() )
 		{
-			m_Dirty.insert( widget );
-			m_DirtyByState.at( IndexOf<State, States...> ).insert( widget );
+			return;
+		}
+		for( auto const reader : it->second )
+		{
+			auto& stale = m_Computed.at( reader ).maybeStale;
+			if( stale )
+			{
+				stale = std::min( *stale, lane );
+				continue;
+			}
+			stale = lane;
+			m_MaybeStale.push_back( reader );
+			markReadersStale( reader, lane );
 		}
 	}
 
-	template<typename State>
-	void runObservers( Key widget )
+	// recompute if anything it read has changed since
+	void refresh( StateId id )
 	{
-		auto const& registry = std::get<ObserverRegistry<State>>( m_ObserverRegistries );
-		if( !registry.Exists( widget ) )
+		auto& computed = m_Computed.at( id );
+		if( computed.isComputing )
+		{
+			throw std::runtime_error{ std::format( "Computed state cycle: widget {} ('{}') reads its own computed state",
+				id.widget, m_WidgetRegistry.at( id.widget ).tag ) };
+		}
+
+		// early exit: up to date
+		if( computed.isFresh && std::ranges::all_of( computed.dependencies,
+			[ this ] ( Dependency const& dependency )
+			{
+				if( m_Computed.contains( dependency.id ) )
+				{
+					refresh( dependency.id );
+				}
+				return version( dependency.id ) == dependency.version;
+			} ) )
 		{
 			return;
 		}
+
+		// recompute, noting what it reads (into a recycled list)
+		std::vector<Dependency> reads;
+		if( m_SpareReads.size() )
+		{
+			reads = std::move( m_SpareReads.back() );
+			m_SpareReads.pop_back();
+		}
+		auto const outer = std::exchange( m_Reads, &reads );
+		computed.isComputing = true;
+		auto changed = false;
+		try
+		{
+			changed = computed.recompute();
+		}
+		catch( ... )
+		{
+			m_Reads = outer;
+			computed.isComputing = false;
+			throw;
+		}
+		m_Reads = outer;
+		computed.isComputing = false;
+
+		// swap the old reads for the new
+		for( auto const& dependency : reads )
+		{
+			m_Readers[ dependency.id ].insert( id );
+		}
+		for( auto const& dependency : computed.dependencies )
+		{
+			auto const isStillRead = std::ranges::any_of( reads, [ &dependency ] ( Dependency const& read ) { return read.id == dependency.id; } );
+			auto it = m_Readers.find( dependency.id );
+			if( !isStillRead && it != m_Readers.end() && it->second.erase( id ) && it->second.empty() )
+			{
+				m_Readers.erase( it );
+				m_Versions.erase( dependency.id );
+			}
+		}
+		std::swap( computed.dependencies, reads );
+		reads.clear();
+		m_SpareReads.push_back( std::move( reads ) );
+		computed.isFresh = true;
+
+		if( changed )
+		{
+			stateChanged( id );
+		}
+	}
+
+	// unobserved ones can wait until they're read
+	void refreshStale()
+	{
+		while( m_MaybeStale.size() )
+		{
+			auto const id = m_MaybeStale.back();
+			m_MaybeStale.pop_back();
+
+			// early continue: destroyed since
+			auto it = m_Computed.find( id );
+			if( it == m_Computed.end() || !it->second.maybeStale )
+			{
+				continue;
+			}
+
+			auto const lane = *std::exchange( it->second.maybeStale, std::nullopt );
+			if( m_Observers.contains( id ) )
+			{
+				m_CurrentLane = lane;
+				refresh( id );
+				m_CurrentLane = Lane::Idle;
+			}
+		}
+	}
+
+	CallbackQueue& callbacks( Lane lane )
+	{
+		return m_Callbacks.at( static_cast<size_t>( lane ) );
+	}
+
+	void runCallback( Lane lane )
+	{
+		auto callback = callbacks( lane ).pop();
+
+		// changes made here inherit the lane and depth
+		m_CurrentLane = lane;
+		m_CurrentDepth = callback.depth;
+		callback.method();
+		m_CurrentLane = Lane::Idle;
+		m_CurrentDepth = 0;
+	}
+
+	// 'id's sets up to its 'number'th, oldest first, so those queued in lower lanes are
+	// promoted to this one; then it's dirty in this lane, as it changes now
+	void applyPending( StateId id, uint64_t number )
+	{
+		auto numApplied = 0;
+		for( auto it = m_PendingSets.find( id ); it != m_PendingSets.end(); it = m_PendingSets.find( id ) )
+		{
+			// early exit: applied already, by a later set in a higher lane
+			auto& pending = it->second;
+			if( pending.applies.empty() || pending.numQueued - pending.applies.size() >= number )
+			{
+				break;
+			}
+
+			// taken first, in case it sets this state again
+			auto apply = std::move( pending.applies.front() );
+			pending.applies.erase( pending.applies.begin() );
+			apply();
+			++numApplied;
+		}
+
+		// early exit: nothing changed
+		if( !numApplied )
+		{
+			return;
+		}
+		stateChanged( id );
+		addDirty( id, m_CurrentLane );
+		invalidateLayers( id.widget, GetRect( id.widget ) );
+	}
+
+	// only observed states; the highest priority and deepest change wins
+	void addDirty( StateId id, Lane lane )
+	{
+		auto it = m_Observers.find( id );
+		if( it == m_Observers.end() || !WidgetExists( id.widget ) )
+		{
+			return;
+		}
+
+		auto& dirty = it->second.dirty;
+		if( !dirty )
+		{
+			dirty = DirtyMark{ .lane = lane, .depth = m_CurrentDepth };
+			m_Dirty.push_back( id );
+			return;
+		}
+		dirty->lane = std::min( dirty->lane, lane );
+		dirty->depth = std::max( dirty->depth, m_CurrentDepth );
+	}
+
+	void runObservers( StateId id )
+	{
+		// early exit: unobserved since
+		auto it = m_Observers.find( id );
+		if( it == m_Observers.end() || !it->second.dirty )
+		{
+			return;
+		}
+		auto const mark = *std::exchange( it->second.dirty, std::nullopt );
+		auto const widget = id.widget;
+
+		// early exit: marked by MarkDirty(), and never observed
+		if( it->second.entries.Empty() )
+		{
+			m_Observers.erase( it );
+			return;
+		}
+
+		// observers that keep setting what they observe would otherwise never settle
+		if( mark.depth >= s_MaxObserverDepth )
+		{
+			throw std::runtime_error{ std::format( "Observer cycle: widget {} ('{}') is still changing {} observers deep",
+				widget, m_WidgetRegistry.at( widget ).tag, mark.depth ) };
+		}
 		
-		auto const& entries = registry.Get( widget );
-		// Console::Print( "\n\t{}, widget {}, {} observers.", State::AsString, widget, entries.size() );
-		for( auto const& entry : entries )
+		// by handle: the entries may move, or be unsubscribed, before the callbacks run
+		auto const& entries = it->second.entries;
+		// Console::Print( "\n\ttype {}, widget {}, {} observers.", id.type, widget, entries.Size() );
+		for( size_t i = 0; i < entries.Size(); ++i )
+		{
+			callbacks( mark.lane ).push( Callback
+				{
+					[ this, handle = observerAt( id, entries, i ) ] ()
+					{
+						if( auto entry = findObserver( handle ) )
+						{
+							Counters::Increment( Counters::ObserverCallbacks );
+							entry->callback();
+						}
+					},
+					mark.depth + 1
+				}
+			);
+		}
+	}
+
+	// nullptr if unsubscribed, even if its slot has been reused since
+	ObserverEntry* findObserver( ObserverHandle handle )
+	{
+		auto it = m_Observers.find( handle.observed );
+		if( it == m_Observers.end() )
+		{
+			return nullptr;
+		}
+		auto entry = it->second.entries.Get( handle.slot );
+		return entry && entry->serial == handle.serial ? entry : nullptr;
+	}
+
+	// the handle of a state's i'th observer
+	ObserverHandle observerAt( StateId id, SlotMap<ObserverEntry> const& entries, size_t i ) const
+	{
+		return ObserverHandle
+		{
+			.observed = id,
+			.slot = entries.HandleAt( i ),
+			.serial = ( entries.begin() + i )->serial
+		};
+	}
+
+	// 0 if it's gone
+	uint32_t incarnationOf( Key widget ) const
+	{
+		auto it = m_WidgetRegistry.find( widget );
+		return it != m_WidgetRegistry.end() ? it->second.incarnation : 0;
+	}
+
+	// children first; 'widget' is already detached from its parent
+	void destroySubtree( Key widget )
+	{
+		for( auto const child : m_WidgetRegistry.at( widget ).children )
+		{
+			destroySubtree( child );
+		}
+		clearWidget( widget );
+		m_WidgetRegistry.erase( widget );
+	}
+
+	// into the pool if it has a signature and there's room; true if pooled
+	bool recycleOrDestroy( Key widget )
+	{
+		auto const& signature = m_WidgetRegistry.at( widget ).signature;
+		if( signature.empty() || !m_WidgetPoolLimit )
+		{
+			destroySubtree( widget );
+			return false;
+		}
+
+		auto& pool = m_WidgetPool[ signature ];
+		if( pool.size() >= m_WidgetPoolLimit )
+		{
+			destroySubtree( widget );
+			return false;
+		}
+
+		recycleSubtree( widget );
+		m_WidgetRegistry.at( widget ).parent = NullKey;
+		pool.push_back( widget );
+		return true;
+	}
+
+	// as destroySubtree(), but the widgets stay, as their creators left them
+	void recycleSubtree( Key widget )
+	{
+		auto& record = m_WidgetRegistry.at( widget );
+		for( auto const child : record.children )
+		{
+			recycleSubtree( child );
+		}
+		clearWidget( widget );
+
+		// its layer, if any, holds what it drew before
+		if( Render::HasLayers() )
+		{
+			Render::InvalidateLayer( widget, record.layout.GetRect() );
+		}
+		record.layout = LayoutBuilder{};
+		record.isCullable = true;
+		record.isInitialised = false;
+		record.isPooled = true;
+		++record.incarnation;
+	}
+
+	// NullKey if there's none
+	Key takeFromPool( std::string const& signature )
+	{
+		// early exit: not recyclable
+		auto it = signature.size() ? m_WidgetPool.find( signature ) : m_WidgetPool.end();
+		if( it == m_WidgetPool.end() || it->second.empty() )
+		{
+			return NullKey;
+		}
+
+		auto const widget = it->second.back();
+		it->second.pop_back();
+		restoreTags( widget );
+		return widget;
+	}
+
+	void restoreTags( Key widget )
+	{
+		auto const& record = m_WidgetRegistry.at( widget );
+		if( record.tag.size() )
 		{
-			m_Callbacks.push( [ &, widget ] () { entry.callback( entry.observer, GetState<State>( widget ) ); } );
+			m_TagRegistry.insert( { record.tag, widget } );
+		}
+		for( auto const child : record.children )
+		{
+			restoreTags( child );
 		}
-		m_DirtyByState.at( IndexOf<State, States...> ).clear();
 	}
 
-	void pushLayouts( Intervals::IntervalBuilder const& widthBuilder, Intervals::IntervalBuilder const& heightBuilder )
+	// all but its record: async tasks, observers both ways, states, tag and hits
+	void clearWidget( Key widget )
+	{
+		CancelAsync( widget );
+
+		// what it observes
+		if( auto it = m_Subscriptions.find( widget ); it != m_Subscriptions.end() )
+		{
+			for( auto const handle : std::vector<ObserverHandle>{ it->second } )
+			{
+				Unsubscribe( handle );
+			}
+		}
+
+		// what observes it: its states' entries sort together
+		auto const first = StateId{ .widget = widget, .type = 0 };
+		auto const last = StateId{ .widget = widget + 1, .type = 0 };
+		for( auto it = m_Observers.lower_bound( first ); it != m_Observers.end() && it->first < last; )
+		{
+			// early continue: marked by MarkDirty(), and never observed
+			if( it->second.entries.Empty() )
+			{
+				it = m_Observers.erase( it );
+				continue;
+			}
+			Unsubscribe( observerAt( it->first, it->second.entries, 0 ) );
+			it = m_Observers.lower_bound( first );
+		}
+
+		// its states, computed or not
+		for( auto it = m_Computed.lower_bound( first ); it != m_Computed.end() && it->first < last; it = m_Computed.erase( it ) )
+		{
+			--m_Stores.at( it->first.type )->numComputed;
+			for( auto const& dependency : it->second.dependencies )
+			{
+				auto readers = m_Readers.find( dependency.id );
+				if( readers != m_Readers.end() && readers->second.erase( it->first ) && readers->second.empty() )
+				{
+					m_Readers.erase( readers );
+					m_Versions.erase( dependency.id );
+				}
+			}
+		}
+		for( auto& store : m_Stores )
+		{
+			store->Erase( widget );
+		}
+		m_PendingSets.erase( m_PendingSets.lower_bound( first ), m_PendingSets.lower_bound( last ) );
+
+		auto const& tag = m_WidgetRegistry.at( widget ).tag;
+		if( auto it = m_TagRegistry.find( tag ); it != m_TagRegistry.end() && it->second == widget )
+		{
+			m_TagRegistry.erase( it );
+		}
+		std::erase( m_HitTree, widget );
+	}
+
+	// layers cache what their owner's subtree draws, so a change to 'widget' over 'area'
+	// invalidates its ancestors' layers. A widget's own states are up to itself.
+	void invalidateLayers( Key widget, Rect area )
+	{
+		// early exit: nothing cached, or destroyed
+		if( !Render::HasLayers() || !WidgetExists( widget ) )
+		{
+			return;
+		}
+
+		for( auto ancestor = m_WidgetRegistry.at( widget ).parent; ancestor != NullKey; ancestor = m_WidgetRegistry.at( ancestor ).parent )
+		{
+			Render::InvalidateLayer( ancestor, area );
+
+			// beyond a widget with its own origin (e.g. scrolled), its descendants' areas mean nothing
+			if( HasState<Transform>( ancestor ) )
+			{
+				area = GetRect( ancestor );
+			}
+		}
+	}
+
+	// 'oldParent' and 'newParent' are the parent's rects before and after this layout
+	void pushLayouts( Intervals::IntervalBuilder const& widthBuilder, Intervals::IntervalBuilder const& heightBuilder, Rect oldParent = {}, Rect newParent = {} )
 	{
 		LayoutBuilder layout{ widthBuilder.WithoutChildren(), heightBuilder.WithoutChildren() };
-		m_WidgetRegistry.at( layout.GetKey() ).layout = layout;
+		auto& widget = m_WidgetRegistry.at( layout.GetKey() );
+		auto oldRect = widget.layout.GetRect();
+		auto newRect = layout.GetRect();
+		widget.layout = layout;
+
+		// moving within its parent, or resizing, changes what the parent's subtree draws;
+		// moving along with its parent doesn't (e.g. a new chat message pushing it down)
+		if( oldRect.x - oldParent.x != newRect.x - newParent.x
+		 || oldRect.y - oldParent.y != newRect.y - newParent.y
+		 || oldRect.w != newRect.w
+		 || oldRect.h != newRect.h )
+		{
+			invalidateLayers( layout.GetKey(), unite( oldRect, newRect ) );
+		}
 
 		auto const& widthChildren = widthBuilder.GetChildren();
 		auto const& heightChildren = heightBuilder.GetChildren();
 
 		for( auto i = 0; i < widthChildren.size(); ++i )
 		{
-			pushLayouts( widthChildren.at( i ), heightChildren.at( i ) );
+			pushLayouts( widthChildren.at( i ), heightChildren.at( i ), oldRect, newRect );
 		}
 	}
 
@@ -432,6 +1343,7 @@ private:
 		}
 
 		// test current layout
+		Counters::Increment( Counters::HitTestNodes );
 		auto const& widget = m_WidgetRegistry.at( tgt );
 		auto runChildren = widget.runHitTest( widget.layout, x, y, hitTree );
 			
@@ -454,12 +1366,7 @@ private:
 	}
 };
 
-using AppDatabase = Database<
-	#include "core/Config.def"
-	#include "user/Config.def"
->;
-
-static AppDatabase db;
+static Database db;
 
 HitTestMethod DefaultHitTest = 
 	[] ( LayoutBuilder const& l, int x, int y, std::vector<Key>& hitTree ) -> bool
@@ -494,6 +1401,11 @@ void RenderLayoutTree( Key root, int x_adjust, int y_adjust )
 	db.RenderLayoutTree( root, x_adjust, y_adjust );
 }
 
+void DisableCulling( Key widget )
+{
+	db.DisableCulling( widget );
+}
+
 void SetRebuildLayoutTree()
 {
 	db.SetRebuildLayoutTree();
@@ -514,6 +1426,26 @@ void FlushCallbacks()
 	db.FlushCallbacks();
 }
 
+void SetFlushBudget( double ms )
+{
+	db.SetFlushBudget( ms );
+}
+
+void OnStatePosted( std::function< void() > wake )
+{
+	db.OnStatePosted( wake );
+}
+
+bool RunAsync( Key owner, AsyncTask task )
+{
+	return db.RunAsync( owner, task );
+}
+
+void CancelAsync( Key owner )
+{
+	db.CancelAsync( owner );
+}
+
 void RunHitTests( Key root, int x, int y )
 {
 	db.RunHitTests( root, x, y );
@@ -536,7 +1468,7 @@ Key CreateWidget( std::string const& tag,
 	HitTestMethod hitTest,
 	std::initializer_list<Key> children )
 {
-	return db.CreateWidget( tag, initMethod, build, hitTest, renderWidget, children );
+	return db.CreateWidget( tag, initMethod, nullptr, build, hitTest, renderWidget, children );
 }
 
 Key CreateWidget( std::string const& tag,
@@ -547,18 +1479,14 @@ Key CreateWidget( std::string const& tag,
 	Custom custom,
 	std::initializer_list<Key> children )
 {
-	return CreateWidget( tag,
+	return db.CreateWidget( tag,
 
 		// initState
+		initMethod,
+
 		// customisation allows composition of original initState
-		// with user-provided one
-		custom.extraInitState
-			? [ initMethod, custom ] ( Key widget )
-				{
-					initMethod( widget );
-					custom.extraInitState( widget );
-				}
-			: initMethod,
+		// with user-provided one, run after it
+		custom.extraInitState,
 
 		// buildLayout
 		// customisation allows to override the original buildLayout
@@ -566,23 +1494,38 @@ Key CreateWidget( std::string const& tag,
 			? custom.overrideBuildLayout
 			: build,
 
-		// renderWidget
-		// customisation allows to override the original renderWidget
-		custom.overrideRenderWidget
-			? custom.overrideRenderWidget
-			: renderWidget,
-
 		// hitTest
 		// customisation allows to override the original hitTest
 		custom.overrideHitTest
 			? custom.overrideHitTest
 			: hitTest,
 
+		// renderWidget
+		// customisation allows to override the original renderWidget
+		custom.overrideRenderWidget
+			? custom.overrideRenderWidget
+			: renderWidget,
+
 		// children
 		children
 	);
 }
 
+void DestroyWidget( Key widget )
+{
+	db.DestroyWidget( widget );
+}
+
+void Unsubscribe( ObserverHandle handle )
+{
+	db.Unsubscribe( handle );
+}
+
+bool WidgetExists( Key widget )
+{
+	return db.WidgetExists( widget );
+}
+
 bool TrueOfAny( Key root, WidgetPredicate predicate )
 {
 	return db.TrueOfAny( root, predicate );
@@ -593,6 +1536,16 @@ Key CreateChildWidget( Key parent, Key child )
 	return db.CreateChildWidget( parent, child );
 }
 
+ChildChanges SetChildren( Key parent, std::vector<ChildDescriptor> const& children )
+{
+	return db.SetChildren( parent, children );
+}
+
+void SetWidgetPoolLimit( size_t subtreesPerSignature )
+{
+	db.SetWidgetPoolLimit( subtreesPerSignature );
+}
+
 Key GetParentWidget( Key child, unsigned int generation )
 {
 	return db.GetParentWidget( child, generation );
@@ -618,46 +1571,46 @@ void ClearHitTree()
 	db.ClearHitTree();
 }
 
-template<typename State>
-void CreateState( Key widget, State s, bool markAsDirty )
+StateStoreBase& RegisterStateStore( std::unique_ptr<StateStoreBase> store )
 {
-	db.CreateState<State>( widget, s, markAsDirty );
+	return db.RegisterStateStore( std::move( store ) );
 }
 
-template<typename State>
-State const& GetState( Key widget )
+namespace StateDb
 {
-	return db.GetState<State>( widget );
-}
+	void MarkDirty( StateId id )
+	{
+		db.MarkDirty( id );
+	}
 
-template<typename State>
-State const& ObserveState( Key observer, Key observed, ObserverMethod<State> callback )
-{
-	return db.ObserveState<State>( observer, observed, callback );
-}
+	bool IsComputing()
+	{
+		return db.IsComputing();
+	}
 
-template<typename State>
-void SetState( Key widget, SetStateMethod<State> setState )
-{
-	db.SetState<State>( widget, setState );
-}
+	void NoteRead( StateId id )
+	{
+		db.NoteRead( id );
+	}
 
-template<typename State>
-bool HasState( Key widget )
-{
-	return db.HasState<State>( widget );
-}
+	ObserverHandle Observe( Key observer, StateId observed, StateMethod callback )
+	{
+		return db.Observe( observer, observed, callback );
+	}
 
+	void Set( StateId id, StateMethod apply, Lane lane )
+	{
+		db.Set( id, apply, lane );
+	}
 
-#define INSTANTIATE_FUNCTION_TEMPLATES( STATE ) \
-template void CreateState( Key widget, STATE s, bool markAsDirty ); \
-template STATE const& GetState( Key widget ); \
-template STATE const& ObserveState( Key observer, Key observed, ObserverMethod<STATE> callback ); \
-template void SetState( Key widget, SetStateMethod<STATE> setState ); \
-template bool HasState<STATE>( Key widget );
+	void Post( StateMethod set )
+	{
+		db.Post( set );
+	}
+
+	void Compute( StateId id, InplaceFunction< bool(), 80 > recompute )
+	{
+		db.Compute( id, recompute );
+	}
 
-INSTANTIATE_FUNCTION_TEMPLATES( WidgetState );
-INSTANTIATE_FUNCTION_TEMPLATES( TextState );
-INSTANTIATE_FUNCTION_TEMPLATES( Transform );
-INSTANTIATE_FUNCTION_TEMPLATES( VisibleChildren );
-INSTANTIATE_FUNCTION_TEMPLATES( OnBuildLayout );
+} // namespace StateDb
@@ -6,18 +6,50 @@
 #include "core/Widget.hpp"
 #include "core/Props.hpp"
 
+#include "core/SlotMap.hpp"
 #include "core/State.hpp"
 #include "user/State.hpp"
 
 #include<Console/Console.hpp>
 
+#include<memory>
+#include<stdexcept>
+#include<stop_token>
+#include<string>
+#include<type_traits>
+#include<unordered_map>
+#include<vector>
+
+template<typename State>
+using ObserverMethod = InplaceFunction< void( Key observer, State const& )>;
+
 template<typename State>
-using ObserverMethod = std::function< void( Key observer, State const& )>;
+using SetStateMethod  = InplaceFunction< void( State& ) >;
 
 template<typename State>
-using SetStateMethod  = std::function< void( State& ) >;
+using ComputeMethod   = InplaceFunction< State( Key self ) >;
 
-using WidgetPredicate = std::function< bool( Key ) >;
+using WidgetPredicate = FunctionRef< bool( Key ) >;
+
+// the typed methods above wrapped with a key or two, as the database keeps them
+using StateMethod = InplaceFunction< void(), 80 >;
+
+// FlushCallbacks() always drains Input; then Normal, then Idle, for as long as
+// its time budget allows, leaving the rest for later frames. A change made
+// while handling a lane is handled at least at that lane's priority. A state's
+// changes apply in the order they were made: one in a higher lane applies those
+// still waiting in lower lanes first.
+enum class Lane
+{
+	Input,
+	Normal,
+	Idle,
+
+	NumLanes
+};
+
+// runs on a worker; returns what to run on the UI thread
+using AsyncTask = std::function< std::function< void() >( std::stop_token ) >;
 
 extern HitTestMethod DefaultHitTest;
 extern HitTestMethod RefuseHitTest;
@@ -29,27 +61,148 @@ void CreateState( Key widget, State s = {}, bool markAsDirty = false );
 template<typename State>
 State const& GetState( Key widget );
 
+// a state derived from others: 'compute' runs again only when read after a state it
+// read last time has changed, and observers are told only when its result differs.
+// Observed computed states are brought up to date during FlushCallbacks().
+template<typename State>
+void CreateComputedState( Key widget, ComputeMethod<State> compute );
+
 template<typename State>
 State const& ObserveState( Key observer, Key observed, ObserverMethod<State> callback );
 
+// ObserveState() returning a handle for Unsubscribe(). Either way, an observer
+// stops observing when it, or the widget it observes, is destroyed.
+struct ObserverHandle;
+
 template<typename State>
-void SetState( Key widget, SetStateMethod<State> setState );
+ObserverHandle SubscribeState( Key observer, Key observed, ObserverMethod<State> callback );
+
+template<typename State>
+void SetState( Key widget, SetStateMethod<State> setState, Lane lane = Lane::Normal );
+
+// SetState from any thread: the change is queued, applied at the start of the
+// UI thread's next FlushCallbacks(), and wakes the main loop if it's sleeping
+template<typename State>
+void PostState( Key widget, SetStateMethod<State> setState, Lane lane = Lane::Normal );
 
 template<typename State>
 bool HasState( Key widget );
 
-#define DECLARE_FUNCTION_TEMPLATES( STATE ) \
-extern template void CreateState( Key widget, STATE s, bool markAsDirty ); \
-extern template STATE const& GetState( Key widget ); \
-extern template STATE const& ObserveState( Key observer, Key observed, ObserverMethod<STATE> callback ); \
-extern template void SetState( Key widget, SetStateMethod<STATE> setState ); \
-extern template bool HasState<STATE>( Key widget );
+/////////////////
+// state types //
+/////////////////
+
+// Any struct with an AsString name (and operator==, to be computed) is a state type,
+// declared in any header. Its store is registered with the database on first use,
+// which gives the type its id; the templates above then reach it in O(1).
 
-DECLARE_FUNCTION_TEMPLATES( WidgetState );
-DECLARE_FUNCTION_TEMPLATES( TextState );
-DECLARE_FUNCTION_TEMPLATES( Transform );
-DECLARE_FUNCTION_TEMPLATES( VisibleChildren );
-DECLARE_FUNCTION_TEMPLATES( OnBuildLayout );
+class StateStoreBase
+{
+public:
+	size_t type = 0;
+	size_t numComputed = 0;
+
+	virtual ~StateStoreBase() = default;
+	virtual void Erase( Key widget ) = 0;
+};
+
+template<typename State>
+class StateStore : public StateStoreBase
+{
+private:
+	using Node = typename std::unordered_map<Key, State>::node_type;
+
+	// erased states' nodes, reused so recycled widgets reinitialise in place
+	static constexpr size_t s_MaxSpareNodes = 1024;
+	std::vector<Node> m_SpareNodes;
+
+public:
+	std::unordered_map<Key, State> states;
+
+	void Insert( Key widget, State s )
+	{
+		// early exit: nothing to reuse
+		if( m_SpareNodes.empty() )
+		{
+			states.insert( { widget, std::move( s ) } );
+			return;
+		}
+
+		auto node = std::move( m_SpareNodes.back() );
+		m_SpareNodes.pop_back();
+		node.key() = widget;
+		node.mapped() = std::move( s );
+		states.insert( std::move( node ) );
+	}
+
+	void Erase( Key widget ) override
+	{
+		auto node = states.extract( widget );
+		if( !node.empty() && m_SpareNodes.size() < s_MaxSpareNodes )
+		{
+			m_SpareNodes.push_back( std::move( node ) );
+		}
+	}
+};
+
+// one of a widget's states
+struct StateId
+{
+	Key widget;
+	size_t type;
+
+	auto operator<=>( StateId const& ) const = default;
+};
+
+// 'serial' is unique across the database: slots are per state, and a state's
+// slots start again once all its observers have gone
+struct ObserverHandle
+{
+	StateId observed;
+	SlotHandle slot;
+	uint64_t serial = 0;
+};
+
+StateStoreBase& RegisterStateStore( std::unique_ptr<StateStoreBase> store );
+
+template<typename State>
+StateStore<State>& GetStateStore()
+{
+	static auto& s_Store = static_cast<StateStore<State>&>( RegisterStateStore( std::make_unique<StateStore<State>>() ) );
+	return s_Store;
+}
+
+template<typename State>
+StateId GetStateId( Key widget )
+{
+	return StateId{ .widget = widget, .type = GetStateStore<State>().type };
+}
+
+// the type-erased halves of the state templates, for them alone
+namespace StateDb
+{
+	void MarkDirty( StateId id );
+	bool IsComputing();
+	void NoteRead( StateId id );
+	ObserverHandle Observe( Key observer, StateId observed, StateMethod callback );
+	void Set( StateId id, StateMethod apply, Lane lane );
+	void Post( StateMethod set );
+	void Compute( StateId id, InplaceFunction< bool(), 80 > recompute );
+
+	// untracked, and mutable
+	template<typename State>
+	State& Get( Key widget )
+	{
+		auto& states = GetStateStore<State>().states;
+		auto it = states.find( widget );
+		if( it == states.end() )
+		{
+			throw std::runtime_error{ std::format( "Widget {} does not have {}", widget, State::AsString ) };
+		}
+		return it->second;
+	}
+
+} // namespace StateDb
 
 Key CreateWidget( std::string const& tag,
 	InitStateMethod initMethod,
@@ -69,10 +222,56 @@ Key CreateWidget( std::string const& tag,
 );
 
 
+// 'widget' and its subtree: their states, observers and async tasks go too.
+// Callbacks already queued for them are dropped.
+void DestroyWidget( Key widget );
+
+void Unsubscribe( ObserverHandle handle );
+
+// false once destroyed (or pooled by SetChildren()): setting its states then does nothing
+bool WidgetExists( Key widget );
+
 bool TrueOfAny( Key root, WidgetPredicate predicate );
 
 Key CreateChildWidget( Key parent, Key child );
 
+// one of the children SetChildren() wants. 'key' tells it from its siblings: 'create'
+// makes it (as CreateWidget() does) if no current child has that key, else 'update',
+// if any, runs on the current one, e.g. to set new props. An empty key never matches.
+//
+// A 'signature' names the kind of subtree 'create' makes, props aside, e.g.
+// "ChatMessage/Jane". Children with one are recycled rather than destroyed: reset to
+// how 'create' left them, and pooled. Under an initialised parent, a child with the
+// same signature then comes from the pool, re-initialised in place (so observing its
+// new surroundings), and 'update' rebinds it to its props.
+struct ChildDescriptor
+{
+	std::string key;
+	InplaceFunction< Key(), WidgetMethodCapacity > create;
+	InitStateMethod update = nullptr;
+	std::string signature;
+};
+
+// what SetChildren() did
+struct ChildChanges
+{
+	size_t created = 0;
+	size_t destroyed = 0;
+	size_t kept = 0;
+	size_t moved = 0;      // of those kept, the fewest that must move to reorder the rest
+	size_t recycled = 0;   // of those created, taken from the pool
+	size_t pooled = 0;     // of those destroyed, put in the pool
+};
+
+// makes 'parent's children the described ones, in order. Current children with a
+// described key are kept, with their states; the others are destroyed. The layout is
+// rebuilt only if the list changed.
+ChildChanges SetChildren( Key parent, std::vector<ChildDescriptor> const& children );
+
+// recycled subtrees kept per signature (default 256); beyond that they're destroyed.
+// 0 turns recycling off, destroying the pool.
+void SetWidgetPoolLimit( size_t subtreesPerSignature );
+
 Layouts::Rect GetWidgetRect( Key widget );
 
 Key GetParentWidget( Key child, unsigned int generation = 0 );
@@ -87,6 +286,10 @@ Layouts::LayoutBuilder BuildLayoutTree( Key root );
 
 void RenderLayoutTree( Key root, int x_adjust = 0, int y_adjust = 0 );
 
+// widgets outside the visible rect aren't rendered, nor are their subtrees;
+// disable that for a widget that draws outside its bounds
+void DisableCulling( Key widget );
+
 void SetRebuildLayoutTree();
 
 bool ShouldRebuildLayoutTree();
@@ -95,6 +298,26 @@ void RebuildLayoutTree( Key root );
 
 void FlushCallbacks();
 
+// milliseconds per FlushCallbacks() for the Normal and Idle lanes
+void SetFlushBudget( double ms );
+
+// called on the posting thread when PostState() finds nothing pending;
+// pass nullptr to clear
+void OnStatePosted( std::function< void() > wake );
+
+// run 'task( stop_token )' on a worker thread, then 'onComplete' with its result on the
+// UI thread during FlushCallbacks(), where it may SetState() as usual. Neither runs
+// after CancelAsync( owner ), and 'task' may poll its stop_token to give up early.
+// Returns false, running nothing, if the workers' queue is full: try again later.
+template<typename Task, typename OnComplete>
+bool RunAsync( Key owner, Task task, OnComplete onComplete );
+
+// the same, with 'task' returning its own continuation
+bool RunAsync( Key owner, AsyncTask task );
+
+// cancel the owner's pending tasks, e.g. when it goes away
+void CancelAsync( Key owner );
+
 // begin at the layout tree node corresponding to the given key 'widget'
 void RunHitTests( Key widget, int x, int y, std::vector<Key>& hitTree );
 
@@ -114,4 +337,114 @@ bool contains( Container const& container, Value v )
 	return std::find( container.cbegin(), container.cend(), v ) != container.cend();
 }
 
+/////////////////////
+// state templates //
+/////////////////////
+
+template<typename State>
+void CreateState( Key widget, State s, bool markAsDirty )
+{
+	GetStateStore<State>().Insert( widget, std::move( s ) );
+	if( markAsDirty )
+	{
+		StateDb::MarkDirty( GetStateId<State>( widget ) );
+	}
+}
+
+template<typename State>
+State const& GetState( Key widget )
+{
+	auto& state = StateDb::Get<State>( widget );
+
+	// bring a computed state up to date, and note what a computation reads
+	if( GetStateStore<State>().numComputed || StateDb::IsComputing() )
+	{
+		StateDb::NoteRead( GetStateId<State>( widget ) );
+	}
+	return state;
+}
+
+template<typename State>
+void CreateComputedState( Key widget, ComputeMethod<State> compute )
+{
+	CreateState<State>( widget );
+	++GetStateStore<State>().numComputed;
+	StateDb::Compute( GetStateId<State>( widget ),
+		[ widget, compute ] () -> bool
+		{
+			auto result = compute( widget );
+			auto& state = StateDb::Get<State>( widget );
+
+			// early exit: no change, so nothing to tell
+			if( result == state )
+			{
+				return false;
+			}
+			state = std::move( result );
+			return true;
+		}
+	);
+}
+
+template<typename State>
+State const& ObserveState( Key observer, Key observed, ObserverMethod<State> callback )
+{
+	SubscribeState<State>( observer, observed, callback );
+	return GetState<State>( observed );
+}
+
+template<typename State>
+ObserverHandle SubscribeState( Key observer, Key observed, ObserverMethod<State> callback )
+{
+	return StateDb::Observe( observer, GetStateId<State>( observed ),
+		[ observer, observed, callback ] ()
+		{
+			callback( observer, GetState<State>( observed ) );
+		}
+	);
+}
+
+template<typename State>
+void SetState( Key widget, SetStateMethod<State> setState, Lane lane )
+{
+	StateDb::Set( GetStateId<State>( widget ), [ widget, setState ] () { setState( StateDb::Get<State>( widget ) ); }, lane );
+}
+
+template<typename State>
+void PostState( Key widget, SetStateMethod<State> setState, Lane lane )
+{
+	// NB: the store is only touched on the UI thread
+	StateDb::Post( [ widget, setState, lane ] () { SetState<State>( widget, setState, lane ); } );
+}
+
+template<typename State>
+bool HasState( Key widget )
+{
+	return GetStateStore<State>().states.contains( widget );
+}
+
+template<typename Task, typename OnComplete>
+bool RunAsync( Key owner, Task task, OnComplete onComplete )
+{
+	return RunAsync( owner, AsyncTask
+		{
+			[ task, onComplete ] ( std::stop_token stop ) -> std::function< void() >
+			{
+				using Result = std::invoke_result_t<Task, std::stop_token>;
+				if constexpr( std::is_void_v<Result> )
+				{
+					task( stop );
+					return onComplete;
+				}
+				else
+				{
+					// shared, as std::function must be copyable
+					auto result = std::make_shared<Result>( task( stop ) );
+					return [ onComplete, result ] () { onComplete( std::move( *result ) ); };
+				}
+			}
+		}
+	);
+}
+
 #endif
\ No newline at end of file
@@ -59,6 +59,9 @@ void FontCache::AddFont(
     throw std::runtime_error{ std::format( "Error while loading font '{}' from file '{}'.", face, file.string() ) };
   }
 
+  // respect the atlas budget
+  FC_SetAtlasBudget( font, m_AtlasBudget );
+
   // default font?
   if( setAsDefault )
   {
@@ -67,4 +70,46 @@ void FontCache::AddFont(
 
   // add to cache
   m_Cache[ face ].push_back( FontDescriptor{ .pointSize = pointSize, .colour = colour, .ttf_style = ttfStyle, .ptr = font } );
+}
+
+void FontCache::SetAtlasBudget( Uint32 bytesPerFont )
+{
+  m_AtlasBudget = bytesPerFont;
+  for( auto const& [ face, fds ] : m_Cache )
+  {
+    for( auto const& fd : fds )
+    {
+      FC_SetAtlasBudget( fd.ptr, m_AtlasBudget );
+    }
+  }
+}
+
+void FontCache::NextFrame()
+{
+  for( auto const& [ face, fds ] : m_Cache )
+  {
+    for( auto const& fd : fds )
+    {
+      FC_AdvanceFrame( fd.ptr );
+    }
+  }
+}
+
+GlyphAtlasCounters FontCache::AtlasCounters() const
+{
+  GlyphAtlasCounters counters;
+  for( auto const& [ face, fds ] : m_Cache )
+  {
+    for( auto const& fd : fds )
+    {
+      auto stats = FC_GetAtlasStats( fd.ptr );
+      counters.bytes            += stats.atlas_bytes;
+      counters.pages            += stats.num_levels;
+      counters.evictions        += stats.evictions;
+      counters.glyphsEvicted    += stats.glyphs_evicted;
+      counters.rasterizations   += stats.rasterizations;
+      counters.rerasterizations += stats.rerasterizations;
+    }
+  }
+  return counters;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include<SDL2/SDL_stdinc.h>
 
+#include<cstdint>
 #include<map>
 #include<string_view>
 #include<vector>
@@ -23,12 +24,24 @@ struct FontDescriptor
   FC_Font* ptr = nullptr;
 };
 
+// glyph atlas usage, summed over all fonts in the cache
+struct GlyphAtlasCounters
+{
+  size_t bytes = 0;
+  int pages = 0;
+  uint64_t evictions = 0;
+  uint64_t glyphsEvicted = 0;
+  uint64_t rasterizations = 0;
+  uint64_t rerasterizations = 0;
+};
+
 class FontCache
 {
 private:
   SDL_Renderer* const& m_Renderer;
   std::map<std::string_view, std::vector<FontDescriptor>> m_Cache;
   FC_Font* m_DefaultFont;
+  Uint32 m_AtlasBudget = 0;
 
 public:
   FontCache( SDL_Renderer* const& renderer );
@@ -44,6 +57,14 @@ public:
 
   FC_Font* DefaultFont() const;
 
+  // per-font limit on glyph atlas texture memory (0 = unlimited)
+  void SetAtlasBudget( Uint32 bytesPerFont );
+
+  // advance the atlas LRU clock of every font
+  void NextFrame();
+
+  GlyphAtlasCounters AtlasCounters() const;
+
 private:
   bool exists( std::string_view face, Uint32 pointSize, rgba32 colour, int ttfStyle );
 
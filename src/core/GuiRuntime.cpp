@@ -8,18 +8,45 @@
 #include<stdexcept>
 #include<format>
 
-GuiRuntime::GuiRuntime( int w, int h )
+GuiRuntime::GuiRuntime( int w, int h, bool headless )
+  : m_Headless{ headless }
 {
+  if( m_Headless )
+  {
+    SDL_setenv( "SDL_VIDEODRIVER", "dummy", 0 );
+  }
+
   if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
   {
     throw std::runtime_error{ std::format( "Error initialising SDL: {}", SDL_GetError() ) };
   }
 
-  if( SDL_CreateWindowAndRenderer( w, h, SDL_WINDOW_HIDDEN, &m_Window, &m_Renderer ) < 0 )
+  // early exit: windowed
+  if( !m_Headless )
+  {
+    if( SDL_CreateWindowAndRenderer( w, h, SDL_WINDOW_HIDDEN, &m_Window, &m_Renderer ) < 0 )
+    {
+      m_Window   = nullptr;
+      m_Renderer = nullptr;
+      throw std::runtime_error{ std::format( "Error creating window: {}", SDL_GetError() ) };
+    }
+
+    Render::Init( m_Renderer );
+    return;
+  }
+
+  // headless: the window is never shown, and the software renderer
+  // draws into its (off-screen) framebuffer
+  m_Window = SDL_CreateWindow( "drui", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, SDL_WINDOW_HIDDEN );
+  if( !m_Window )
   {
-    m_Window   = nullptr;
-    m_Renderer = nullptr;
-    throw std::runtime_error{ std::format( "Error creating window: {}", SDL_GetError() ) };
+    throw std::runtime_error{ std::format( "Error creating headless window: {}", SDL_GetError() ) };
+  }
+
+  m_Renderer = SDL_CreateRenderer( m_Window, -1, SDL_RENDERER_SOFTWARE );
+  if( !m_Renderer )
+  {
+    throw std::runtime_error{ std::format( "Error creating software renderer: {}", SDL_GetError() ) };
   }
 
   Render::Init( m_Renderer );
@@ -42,5 +69,15 @@ GuiRuntime::~GuiRuntime()
 
 void GuiRuntime::ShowWindow() const
 {
+  // early exit: nothing to show
+  if( m_Headless )
+  {
+    return;
+  }
   SDL_ShowWindow( m_Window );
+}
+
+bool GuiRuntime::IsHeadless() const
+{
+  return m_Headless;
 }
\ No newline at end of file
@@ -11,12 +11,16 @@ class GuiRuntime
 private:
   SDL_Window*   m_Window = nullptr;
   SDL_Renderer* m_Renderer = nullptr;
+  bool          m_Headless = false;
 
 public:
-  GuiRuntime( int w, int h );
+  // headless: no visible window and a software renderer, on SDL's dummy
+  // video driver (unless SDL_VIDEODRIVER names another, e.g. "offscreen")
+  GuiRuntime( int w, int h, bool headless = false );
   ~GuiRuntime();
 
   void ShowWindow() const;
+  bool IsHeadless() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,220 @@
+// InplaceFunction.hpp
+// callables without the heap
+//
+// InplaceFunction is std::function with the callable stored inline: one that doesn't fit
+// in 'Capacity' bytes is a compile error, never an allocation. It stays copyable, as
+// widgets and layout builders are copied about, so its callables must be too.
+// FunctionRef is a non-owning view of a callable, for parameters only called before
+// the callee returns.
+
+#ifndef CORE_INPLACE_FUNCTION_HPP_INCLUDED
+#define CORE_INPLACE_FUNCTION_HPP_INCLUDED
+
+#include<concepts>
+#include<cstddef>
+#include<functional>
+#include<memory>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+// six pointers' worth: enough for most lambdas capturing keys, 'this' and a value or two
+constexpr size_t DefaultInplaceCapacity = 48;
+
+template<typename Signature, size_t Capacity = DefaultInplaceCapacity>
+class InplaceFunction;
+
+namespace InplaceFunctionDetail
+{
+  // callables that may be empty, and so make an empty InplaceFunction
+  template<typename T>
+  constexpr bool IsNullable = std::is_pointer_v<T> || std::is_member_pointer_v<T>;
+
+  template<typename Signature>
+  constexpr bool IsNullable<std::function<Signature>> = true;
+
+  template<typename Signature, size_t Capacity>
+  constexpr bool IsNullable<InplaceFunction<Signature, Capacity>> = true;
+
+} // namespace InplaceFunctionDetail
+
+template<typename R, typename ... Args, size_t Capacity>
+class InplaceFunction<R( Args... ), Capacity>
+{
+private:
+  struct Ops
+  {
+    R    ( *invoke )( void* callable, Args&&... args );
+    void ( *copy )( void* dst, void const* src );
+    void ( *move )( void* dst, void* src );   // and destroy 'src'
+    void ( *destroy )( void* callable );
+  };
+
+  template<typename F>
+  static constexpr Ops s_Ops
+  {
+    .invoke = [] ( void* callable, Args&&... args ) -> R
+    {
+      return std::invoke( *static_cast<F*>( callable ), std::forward<Args>( args )... );
+    },
+    .copy = [] ( void* dst, void const* src )
+    {
+      ::new( dst ) F( *static_cast<F const*>( src ) );
+    },
+    .move = [] ( void* dst, void* src )
+    {
+      ::new( dst ) F( std::move( *static_cast<F*>( src ) ) );
+      static_cast<F*>( src )->~F();
+    },
+    .destroy = [] ( void* callable )
+    {
+      static_cast<F*>( callable )->~F();
+    }
+  };
+
+  alignas( void* ) mutable std::byte m_Storage[ Capacity ];
+  Ops const* m_Ops = nullptr;
+
+public:
+  InplaceFunction() = default;
+
+  InplaceFunction( std::nullptr_t )
+  { }
+
+  template<typename F>
+    requires( !std::same_as<std::remove_cvref_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...> )
+  InplaceFunction( F&& f )
+  {
+    using Callable = std::decay_t<F>;
+    static_assert( sizeof( Callable ) <= Capacity, "InplaceFunction: callable too big; capture less, or raise the capacity" );
+    static_assert( alignof( Callable ) <= alignof( void* ), "InplaceFunction: callable over-aligned" );
+    static_assert( std::is_copy_constructible_v<Callable>, "InplaceFunction: callable must be copyable" );
+
+    auto callable = ::new( m_Storage ) Callable( std::forward<F>( f ) );
+    m_Ops = &s_Ops<Callable>;
+
+    // an empty function pointer or std::function makes an empty InplaceFunction
+    if constexpr( InplaceFunctionDetail::IsNullable<Callable> )
+    {
+      if( !*callable )
+      {
+        reset();
+      }
+    }
+  }
+
+  InplaceFunction( InplaceFunction const& other )
+    : m_Ops{ other.m_Ops }
+  {
+    if( m_Ops )
+    {
+      m_Ops->copy( m_Storage, other.m_Storage );
+    }
+  }
+
+  InplaceFunction( InplaceFunction&& other ) noexcept
+    : m_Ops{ std::exchange( other.m_Ops, nullptr ) }
+  {
+    if( m_Ops )
+    {
+      m_Ops->move( m_Storage, other.m_Storage );
+    }
+  }
+
+  InplaceFunction& operator=( InplaceFunction const& other )
+  {
+    if( this != &other )
+    {
+      reset();
+      if( other.m_Ops )
+      {
+        other.m_Ops->copy( m_Storage, other.m_Storage );
+        m_Ops = other.m_Ops;
+      }
+    }
+    return *this;
+  }
+
+  InplaceFunction& operator=( InplaceFunction&& other ) noexcept
+  {
+    if( this != &other )
+    {
+      reset();
+      if( other.m_Ops )
+      {
+        other.m_Ops->move( m_Storage, other.m_Storage );
+        m_Ops = std::exchange( other.m_Ops, nullptr );
+      }
+    }
+    return *this;
+  }
+
+  InplaceFunction& operator=( std::nullptr_t )
+  {
+    reset();
+    return *this;
+  }
+
+  ~InplaceFunction()
+  {
+    reset();
+  }
+
+  R operator()( Args... args ) const
+  {
+    if( !m_Ops )
+    {
+      throw std::bad_function_call{};
+    }
+    return m_Ops->invoke( m_Storage, std::forward<Args>( args )... );
+  }
+
+  explicit operator bool() const
+  {
+    return m_Ops;
+  }
+
+  bool operator==( std::nullptr_t ) const
+  {
+    return !m_Ops;
+  }
+
+private:
+  void reset()
+  {
+    if( m_Ops )
+    {
+      std::exchange( m_Ops, nullptr )->destroy( m_Storage );
+    }
+  }
+};
+
+template<typename Signature>
+class FunctionRef;
+
+template<typename R, typename ... Args>
+class FunctionRef<R( Args... )>
+{
+private:
+  void* m_Callable;
+  R ( *m_Invoke )( void* callable, Args&&... args );
+
+public:
+  // NB: 'f' must outlive the FunctionRef, so don't keep one
+  template<typename F>
+    requires( !std::same_as<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...> )
+  FunctionRef( F&& f )
+    : m_Callable{ const_cast<void*>( static_cast<void const*>( std::addressof( f ) ) ) },
+      m_Invoke{ [] ( void* callable, Args&&... args ) -> R
+        {
+          return std::invoke( *static_cast<std::remove_reference_t<F>*>( callable ), std::forward<Args>( args )... );
+        } }
+  { }
+
+  R operator()( Args... args ) const
+  {
+    return m_Invoke( m_Callable, std::forward<Args>( args )... );
+  }
+};
+
+#endif
@@ -0,0 +1,81 @@
+// InputTrace.cpp
+
+#include "InputTrace.hpp"
+
+#include<algorithm>
+#include<array>
+#include<format>
+#include<fstream>
+#include<sstream>
+#include<stdexcept>
+#include<string_view>
+
+static constexpr auto s_Header = "drui-input-trace 1";
+
+static constexpr std::array<std::string_view, 5> s_TypeNames =
+{
+  "move", "down", "up", "wheel", "quit"
+};
+
+InputTrace LoadInputTrace( std::string const& path )
+{
+  std::ifstream file{ path };
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Could not open input trace '{}'", path ) };
+  }
+
+  std::string line;
+  if( !std::getline( file, line ) || line != s_Header )
+  {
+    throw std::runtime_error{ std::format( "'{}' is not an input trace", path ) };
+  }
+
+  InputTrace trace;
+  auto lineNumber = 1;
+  while( std::getline( file, line ) )
+  {
+    ++lineNumber;
+
+    // skip blank lines
+    if( line.empty() )
+    {
+      continue;
+    }
+
+    std::istringstream fields{ line };
+    std::string typeName;
+    InputEvent event;
+    fields >> event.frame >> typeName >> event.x >> event.y >> event.wheel >> event.button;
+
+    auto type = std::find( s_TypeNames.cbegin(), s_TypeNames.cend(), typeName );
+    if( !fields || type == s_TypeNames.cend() )
+    {
+      throw std::runtime_error{ std::format( "Malformed input trace '{}', line {}", path, lineNumber ) };
+    }
+    event.type = static_cast<InputType>( type - s_TypeNames.cbegin() );
+    trace.push_back( event );
+  }
+  return trace;
+}
+
+void SaveInputTrace( std::string const& path, InputTrace const& trace )
+{
+  std::ofstream file{ path };
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Could not open '{}' for writing", path ) };
+  }
+
+  file << s_Header << '\n';
+  for( auto const& event : trace )
+  {
+    file << std::format( "{} {} {} {} {} {}\n",
+      event.frame, s_TypeNames.at( static_cast<size_t>( event.type ) ), event.x, event.y, event.wheel, event.button );
+  }
+
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Failed writing input trace '{}'", path ) };
+  }
+}
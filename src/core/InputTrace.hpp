@@ -0,0 +1,36 @@
+// InputTrace.hpp
+// mouse input, recorded from a live session and replayed frame by frame
+
+#ifndef CORE_INPUT_TRACE_HPP_INCLUDED
+#define CORE_INPUT_TRACE_HPP_INCLUDED
+
+#include<cstdint>
+#include<string>
+#include<vector>
+
+enum class InputType
+{
+  MouseMove,
+  MouseDown,
+  MouseUp,
+  Wheel,
+  Quit
+};
+
+struct InputEvent
+{
+  uint32_t frame = 0;   // frame the event arrived in
+  InputType type = InputType::MouseMove;
+  int x = 0;            // mouse position (MouseMove, MouseDown, MouseUp)
+  int y = 0;
+  int wheel = 0;        // wheel ticks (Wheel)
+  int button = 0;       // SDL button index (MouseDown, MouseUp)
+};
+
+using InputTrace = std::vector<InputEvent>;
+
+// plain text, one event per line; throw on failure
+InputTrace LoadInputTrace( std::string const& path );
+void SaveInputTrace( std::string const& path, InputTrace const& trace );
+
+#endif
@@ -0,0 +1,68 @@
+// MpscQueue.hpp
+// unbounded lock-free queue: any thread may Push(), one thread may Pop()
+//
+// A linked list with a stub node (Vyukov's MPSC queue). Push() is one atomic exchange;
+// a Pop() racing a Push() may briefly miss that item, which the next Pop() then sees.
+
+#ifndef CORE_MPSC_QUEUE_HPP_INCLUDED
+#define CORE_MPSC_QUEUE_HPP_INCLUDED
+
+#include<atomic>
+#include<utility>
+
+template<typename T>
+class MpscQueue
+{
+private:
+  struct Node
+  {
+    std::atomic<Node*> next = nullptr;
+    T value;
+  };
+
+  std::atomic<Node*> m_Head;  // producers push here
+  Node* m_Tail;               // the consumer's stub; its next is the front
+
+public:
+  MpscQueue()
+    : m_Head{ new Node },
+      m_Tail{ m_Head.load() }
+  { }
+
+  ~MpscQueue()
+  {
+    T value;
+    while( Pop( value ) ) { }
+    delete m_Tail;
+  }
+
+  MpscQueue( MpscQueue const& ) = delete;
+  MpscQueue& operator=( MpscQueue const& ) = delete;
+
+  // any thread
+  void Push( T value )
+  {
+    auto node = new Node;
+    node->value = std::move( value );
+    auto prev = m_Head.exchange( node, std::memory_order_acq_rel );
+    prev->next.store( node, std::memory_order_release );
+  }
+
+  // consumer thread only
+  bool Pop( T& value )
+  {
+    auto next = m_Tail->next.load( std::memory_order_acquire );
+    if( !next )
+    {
+      return false;
+    }
+
+    // 'next' becomes the stub
+    value = std::move( next->value );
+    delete m_Tail;
+    m_Tail = next;
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,83 @@
+// NullBackend.cpp
+
+#include "RenderBackend.hpp"
+
+#include<format>
+#include<stdexcept>
+
+void NullBackend::ClearScreen()
+{
+  ++m_Stats.clears;
+  m_InFrame = true;
+}
+
+void NullBackend::Present()
+{
+  if( !m_InFrame )
+  {
+    throw std::runtime_error{ "NullBackend: Present() without a preceding ClearScreen()" };
+  }
+  ++m_Stats.presents;
+  m_InFrame = false;
+}
+
+void NullBackend::DrawRect( Rect r, rgba32 colour )
+{
+  validate( r, "DrawRect()" );
+  ++m_Stats.rects;
+}
+
+void NullBackend::DrawFilledRect( Rect r, rgba32 colour )
+{
+  validate( r, "DrawFilledRect()" );
+  ++m_Stats.filledRects;
+}
+
+void NullBackend::DrawRoundedBox( Rect r, int radius, rgba32 colour )
+{
+  validate( r, "DrawRoundedBox()" );
+  if( radius < 0 )
+  {
+    throw std::runtime_error{ std::format( "NullBackend: DrawRoundedBox() with negative radius {}", radius ) };
+  }
+  ++m_Stats.roundedBoxes;
+}
+
+void NullBackend::DrawText( Rect r, std::string const& s )
+{
+  validate( r, "DrawText()" );
+  ++m_Stats.texts;
+  m_Stats.textBytes += s.size();
+}
+
+void NullBackend::SetClipRect( Rect clip )
+{
+  if( clip.w < 0 || clip.h < 0 )
+  {
+    throw std::runtime_error{ std::format( "NullBackend: SetClipRect() with negative size {}x{}", clip.w, clip.h ) };
+  }
+  ++m_Stats.clipChanges;
+}
+
+void NullBackend::ResetClipRect()
+{
+  ++m_Stats.clipChanges;
+}
+
+NullBackend::Stats const& NullBackend::GetStats() const
+{
+  return m_Stats;
+}
+
+void NullBackend::validate( Rect r, char const* command ) const
+{
+  if( !m_InFrame )
+  {
+    throw std::runtime_error{ std::format( "NullBackend: {} outside ClearScreen() ... Present()", command ) };
+  }
+
+  if( r.w < 0 || r.h < 0 )
+  {
+    throw std::runtime_error{ std::format( "NullBackend: {} with negative size {}x{}", command, r.w, r.h ) };
+  }
+}
@@ -0,0 +1,126 @@
+// Profiler.cpp
+
+#include "Profiler.hpp"
+
+#ifdef DRUI_PROFILE
+
+#include "Console/Console.hpp"
+
+#include<array>
+#include<atomic>
+#include<fstream>
+#include<memory>
+#include<mutex>
+#include<vector>
+
+namespace Profiler
+{
+  struct Event
+  {
+    char const* name;
+    uint64_t arg;
+    Clock::time_point begin;
+    Clock::time_point end;
+  };
+
+  // per-thread ring buffer: written only by its own thread
+  struct ThreadBuffer
+  {
+    static constexpr size_t s_Capacity = 1 << 16;
+
+    uint32_t tid;
+    char const* name = nullptr;
+    std::atomic<uint64_t> count = 0;  // total events ever recorded
+    std::array<Event, s_Capacity> events;
+  };
+
+  // buffers are kept after their thread exits, so its events still get written
+  static std::mutex s_BuffersMutex;
+  static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+  static Clock::time_point const s_Epoch = Clock::now();
+
+  static ThreadBuffer& threadBuffer()
+  {
+    thread_local ThreadBuffer* t_Buffer = nullptr;
+    if( !t_Buffer )
+    {
+      std::lock_guard lock{ s_BuffersMutex };
+      auto& buffer = s_Buffers.emplace_back( std::make_unique<ThreadBuffer>() );
+      buffer->tid = static_cast<uint32_t>( s_Buffers.size() );
+      t_Buffer = buffer.get();
+    }
+    return *t_Buffer;
+  }
+
+  void Record( char const* name, uint64_t arg, Clock::time_point begin, Clock::time_point end )
+  {
+    auto& buffer = threadBuffer();
+    auto const n = buffer.count.load( std::memory_order_relaxed );
+    buffer.events[ n % ThreadBuffer::s_Capacity ] = Event{ name, arg, begin, end };
+    buffer.count.store( n + 1, std::memory_order_release );
+  }
+
+  void NameThread( char const* name )
+  {
+    threadBuffer().name = name;
+  }
+
+  static double microseconds( Clock::time_point t )
+  {
+    return std::chrono::duration<double, std::micro>( t - s_Epoch ).count();
+  }
+
+  bool WriteTrace( char const* path )
+  {
+    std::ofstream file{ path };
+    if( !file )
+    {
+      Console::ErrorLn( "Profiler: could not open '{}' for writing.", path );
+      return false;
+    }
+
+    std::lock_guard lock{ s_BuffersMutex };
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    auto separator = "\n";
+    size_t numEvents = 0;
+    for( auto const& buffer : s_Buffers )
+    {
+      // thread label
+      if( buffer->name )
+      {
+        file << separator << std::format( "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+          buffer->tid, buffer->name );
+        separator = ",\n";
+      }
+
+      // oldest to newest
+      auto const count = buffer->count.load( std::memory_order_acquire );
+      auto const first = count > ThreadBuffer::s_Capacity ? count - ThreadBuffer::s_Capacity : 0;
+      for( auto i = first; i < count; ++i )
+      {
+        auto const& event = buffer->events[ i % ThreadBuffer::s_Capacity ];
+        file << separator << std::format( "{{\"name\":\"{}\",\"cat\":\"drui\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+          event.name, buffer->tid, microseconds( event.begin ), microseconds( event.end ) - microseconds( event.begin ) );
+        if( event.arg != NoArg )
+        {
+          file << std::format( ",\"args\":{{\"key\":{}}}", event.arg );
+        }
+        file << '}';
+        separator = ",\n";
+      }
+      numEvents += count - first;
+    }
+    file << "\n]}\n";
+
+    if( !file )
+    {
+      Console::ErrorLn( "Profiler: failed writing '{}'.", path );
+      return false;
+    }
+    Console::PrintLn( "Profiler: wrote {} events to '{}'.", numEvents, path );
+    return true;
+  }
+
+} // namespace Profiler
+
+#endif // DRUI_PROFILE
@@ -0,0 +1,88 @@
+// Profiler.hpp
+// scoped frame-phase timers, exported as a Chrome / Perfetto trace
+//
+// Build with DRUI_PROFILE defined to enable; otherwise every macro below
+// compiles to nothing. Define DRUI_PROFILE_WIDGETS as well to time the
+// build and render calls of individual widgets.
+//
+// Each thread records into its own fixed-size ring buffer, so only the most
+// recent events are kept. Open the written file in about:tracing or
+// https://ui.perfetto.dev.
+
+#ifndef CORE_PROFILER_HPP_INCLUDED
+#define CORE_PROFILER_HPP_INCLUDED
+
+#ifdef DRUI_PROFILE
+
+#include<chrono>
+#include<cstdint>
+
+namespace Profiler
+{
+  using Clock = std::chrono::steady_clock;
+
+  // no event argument
+  constexpr uint64_t NoArg = ~uint64_t{ 0 };
+
+  // 'name' must be a string literal (only the pointer is stored)
+  void Record( char const* name, uint64_t arg, Clock::time_point begin, Clock::time_point end );
+
+  // label the calling thread in the trace
+  void NameThread( char const* name );
+
+  // write every buffered event as trace event JSON; call while
+  // other threads are idle (e.g. between frames).
+  // Returns false if the file could not be written.
+  bool WriteTrace( char const* path );
+
+  class Scope
+  {
+  private:
+    char const* m_Name;
+    uint64_t m_Arg;
+    Clock::time_point m_Begin;
+
+  public:
+    explicit Scope( char const* name, uint64_t arg = NoArg )
+      : m_Name{ name },
+        m_Arg{ arg },
+        m_Begin{ Clock::now() }
+    { }
+
+    ~Scope()
+    {
+      Record( m_Name, m_Arg, m_Begin, Clock::now() );
+    }
+
+    Scope( Scope const& ) = delete;
+    Scope& operator=( Scope const& ) = delete;
+  };
+
+} // namespace Profiler
+
+#define DRUI_PROFILE_CONCAT_IMPL( a, b ) a##b
+#define DRUI_PROFILE_CONCAT( a, b ) DRUI_PROFILE_CONCAT_IMPL( a, b )
+
+#define DRUI_PROFILE_SCOPE( name ) Profiler::Scope DRUI_PROFILE_CONCAT( drui_profile_scope_, __LINE__ ){ name }
+#define DRUI_PROFILE_THREAD( name ) Profiler::NameThread( name )
+#define DRUI_PROFILE_WRITE( path ) Profiler::WriteTrace( path )
+
+#ifdef DRUI_PROFILE_WIDGETS
+#define DRUI_PROFILE_WIDGET_SCOPE( name, key ) Profiler::Scope DRUI_PROFILE_CONCAT( drui_profile_scope_, __LINE__ ){ name, key }
+#else
+#define DRUI_PROFILE_WIDGET_SCOPE( name, key ) ( (void)0 )
+#endif
+
+#else
+
+#define DRUI_PROFILE_SCOPE( name ) ( (void)0 )
+#define DRUI_PROFILE_THREAD( name ) ( (void)0 )
+#define DRUI_PROFILE_WRITE( path ) ( (void)0 )
+#define DRUI_PROFILE_WIDGET_SCOPE( name, key ) ( (void)0 )
+
+#endif // DRUI_PROFILE
+
+// default trace file, written on F12 and at exit
+#define DRUI_PROFILE_TRACE_PATH "drui.trace.json"
+
+#endif
@@ -0,0 +1,390 @@
+// Raster.cpp
+
+#include "Raster.hpp"
+
+#include<SDL2/SDL.h>
+
+#include<cstring>
+#include<format>
+#include<map>
+#include<stdexcept>
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#define RASTER_X86 1
+#include<immintrin.h>
+#else
+#define RASTER_X86 0
+#endif
+
+// MSVC compiles any intrinsic anywhere; gcc and clang need the target per function
+#if RASTER_X86 && !defined( _MSC_VER )
+#define RASTER_TARGET( isa ) __attribute__(( target( isa ) ))
+#else
+#define RASTER_TARGET( isa )
+#endif
+
+namespace Raster
+{
+  ////////////
+  // scalar //
+  ////////////
+
+  // x / 255, exact for x < 65535 (as the vector kernels compute it)
+  static inline uint32_t div255( uint32_t x )
+  {
+    return ( x + 1 + ( x >> 8 ) ) >> 8;
+  }
+
+  static inline rgba32 blendPixel( rgba32 src, uint32_t a, rgba32 dst )
+  {
+    auto const ia = 255 - a;
+    auto channel = [ a, ia ] ( uint32_t s, uint32_t d )
+    {
+      return static_cast<uint8_t>( div255( s * a + d * ia + 127 ) );
+    };
+    return rgba32{ channel( src.r, dst.r ), channel( src.g, dst.g ), channel( src.b, dst.b ), channel( 255, dst.a ) };
+  }
+
+  static void fillSpanScalar( rgba32* dst, int count, rgba32 colour )
+  {
+    for( auto i = 0; i < count; ++i )
+    {
+      dst[ i ] = colour;
+    }
+  }
+
+  static void blendSpanScalar( rgba32* dst, int count, rgba32 colour )
+  {
+    for( auto i = 0; i < count; ++i )
+    {
+      dst[ i ] = blendPixel( colour, colour.a, dst[ i ] );
+    }
+  }
+
+  static void blendMaskSpanScalar( rgba32* dst, uint8_t const* mask, int count, rgba32 colour )
+  {
+    for( auto i = 0; i < count; ++i )
+    {
+      dst[ i ] = blendPixel( colour, div255( colour.a * mask[ i ] + 127 ), dst[ i ] );
+    }
+  }
+
+#if RASTER_X86
+
+  static inline uint32_t packed( rgba32 colour )
+  {
+    uint32_t p;
+    std::memcpy( &p, &colour, sizeof( p ) );
+    return p;
+  }
+
+  //////////
+  // SSE2 //
+  //////////
+
+  // the colour with its alpha channel set to 255 (so alpha composites like the other channels)
+  RASTER_TARGET( "sse2" )
+  static inline __m128i opaqueSource128( rgba32 colour )
+  {
+    colour.a = 255;
+    return _mm_unpacklo_epi8( _mm_set1_epi32( static_cast<int>( packed( colour ) ) ), _mm_setzero_si128() );
+  }
+
+  RASTER_TARGET( "sse2" )
+  static inline __m128i div255_128( __m128i x )
+  {
+    return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( x, 8 ) ), 8 );
+  }
+
+  // blend 16-bit lanes: ( s * a + d * ( 255 - a ) + 127 ) / 255
+  RASTER_TARGET( "sse2" )
+  static inline __m128i blend128( __m128i s, __m128i a, __m128i d )
+  {
+    auto const ia = _mm_sub_epi16( _mm_set1_epi16( 255 ), a );
+    auto const x = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( s, a ), _mm_mullo_epi16( d, ia ) ), _mm_set1_epi16( 127 ) );
+    return div255_128( x );
+  }
+
+  RASTER_TARGET( "sse2" )
+  static void fillSpanSse2( rgba32* dst, int count, rgba32 colour )
+  {
+    auto const c = _mm_set1_epi32( static_cast<int>( packed( colour ) ) );
+    auto i = 0;
+    for( ; i + 4 <= count; i += 4 )
+    {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), c );
+    }
+    fillSpanScalar( dst + i, count - i, colour );
+  }
+
+  RASTER_TARGET( "sse2" )
+  static void blendSpanSse2( rgba32* dst, int count, rgba32 colour )
+  {
+    auto const zero = _mm_setzero_si128();
+    auto const s = opaqueSource128( colour );
+    auto const a = _mm_set1_epi16( colour.a );
+    auto i = 0;
+    for( ; i + 4 <= count; i += 4 )
+    {
+      auto const d = _mm_loadu_si128( reinterpret_cast<__m128i const*>( dst + i ) );
+      auto const lo = blend128( s, a, _mm_unpacklo_epi8( d, zero ) );
+      auto const hi = blend128( s, a, _mm_unpackhi_epi8( d, zero ) );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packus_epi16( lo, hi ) );
+    }
+    blendSpanScalar( dst + i, count - i, colour );
+  }
+
+  RASTER_TARGET( "sse2" )
+  static void blendMaskSpanSse2( rgba32* dst, uint8_t const* mask, int count, rgba32 colour )
+  {
+    auto const zero = _mm_setzero_si128();
+    auto const s = opaqueSource128( colour );
+    auto const alpha = _mm_set1_epi16( colour.a );
+    auto i = 0;
+    for( ; i + 4 <= count; i += 4 )
+    {
+      // four mask bytes, each repeated across its pixel's four channels
+      int m;
+      std::memcpy( &m, mask + i, sizeof( m ) );
+      auto mm = _mm_cvtsi32_si128( m );
+      mm = _mm_unpacklo_epi8( mm, mm );
+      mm = _mm_unpacklo_epi16( mm, mm );
+
+      // per-pixel alpha = colour alpha scaled by the mask
+      auto const aLo = div255_128( _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( mm, zero ), alpha ), _mm_set1_epi16( 127 ) ) );
+      auto const aHi = div255_128( _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( mm, zero ), alpha ), _mm_set1_epi16( 127 ) ) );
+
+      auto const d = _mm_loadu_si128( reinterpret_cast<__m128i const*>( dst + i ) );
+      auto const lo = blend128( s, aLo, _mm_unpacklo_epi8( d, zero ) );
+      auto const hi = blend128( s, aHi, _mm_unpackhi_epi8( d, zero ) );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packus_epi16( lo, hi ) );
+    }
+    blendMaskSpanScalar( dst + i, mask + i, count - i, colour );
+  }
+
+  //////////
+  // AVX2 //
+  //////////
+
+  RASTER_TARGET( "avx2" )
+  static inline __m256i div255_256( __m256i x )
+  {
+    return _mm256_srli_epi16( _mm256_add_epi16( _mm256_add_epi16( x, _mm256_set1_epi16( 1 ) ), _mm256_srli_epi16( x, 8 ) ), 8 );
+  }
+
+  RASTER_TARGET( "avx2" )
+  static inline __m256i blend256( __m256i s, __m256i a, __m256i d )
+  {
+    auto const ia = _mm256_sub_epi16( _mm256_set1_epi16( 255 ), a );
+    auto const x = _mm256_add_epi16( _mm256_add_epi16( _mm256_mullo_epi16( s, a ), _mm256_mullo_epi16( d, ia ) ), _mm256_set1_epi16( 127 ) );
+    return div255_256( x );
+  }
+
+  RASTER_TARGET( "avx2" )
+  static inline __m256i opaqueSource256( rgba32 colour )
+  {
+    colour.a = 255;
+    return _mm256_unpacklo_epi8( _mm256_set1_epi32( static_cast<int>( packed( colour ) ) ), _mm256_setzero_si256() );
+  }
+
+  RASTER_TARGET( "avx2" )
+  static void fillSpanAvx2( rgba32* dst, int count, rgba32 colour )
+  {
+    auto const c = _mm256_set1_epi32( static_cast<int>( packed( colour ) ) );
+    auto i = 0;
+    for( ; i + 8 <= count; i += 8 )
+    {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), c );
+    }
+    fillSpanScalar( dst + i, count - i, colour );
+  }
+
+  RASTER_TARGET( "avx2" )
+  static void blendSpanAvx2( rgba32* dst, int count, rgba32 colour )
+  {
+    auto const zero = _mm256_setzero_si256();
+    auto const s = opaqueSource256( colour );
+    auto const a = _mm256_set1_epi16( colour.a );
+    auto i = 0;
+    for( ; i + 8 <= count; i += 8 )
+    {
+      auto const d = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( dst + i ) );
+      auto const lo = blend256( s, a, _mm256_unpacklo_epi8( d, zero ) );
+      auto const hi = blend256( s, a, _mm256_unpackhi_epi8( d, zero ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), _mm256_packus_epi16( lo, hi ) );
+    }
+    blendSpanScalar( dst + i, count - i, colour );
+  }
+
+  RASTER_TARGET( "avx2" )
+  static void blendMaskSpanAvx2( rgba32* dst, uint8_t const* mask, int count, rgba32 colour )
+  {
+    auto const zero = _mm256_setzero_si256();
+    auto const s = opaqueSource256( colour );
+    auto const alpha = _mm256_set1_epi16( colour.a );
+    auto i = 0;
+    for( ; i + 8 <= count; i += 8 )
+    {
+      // eight mask bytes, each repeated across its pixel's four channels
+      long long m;
+      std::memcpy( &m, mask + i, sizeof( m ) );
+      auto const mm = _mm256_mullo_epi32( _mm256_cvtepu8_epi32( _mm_cvtsi64_si128( m ) ), _mm256_set1_epi32( 0x01010101 ) );
+
+      // per-pixel alpha = colour alpha scaled by the mask
+      auto const aLo = div255_256( _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpacklo_epi8( mm, zero ), alpha ), _mm256_set1_epi16( 127 ) ) );
+      auto const aHi = div255_256( _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpackhi_epi8( mm, zero ), alpha ), _mm256_set1_epi16( 127 ) ) );
+
+      auto const d = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( dst + i ) );
+      auto const lo = blend256( s, aLo, _mm256_unpacklo_epi8( d, zero ) );
+      auto const hi = blend256( s, aHi, _mm256_unpackhi_epi8( d, zero ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), _mm256_packus_epi16( lo, hi ) );
+    }
+    blendMaskSpanScalar( dst + i, mask + i, count - i, colour );
+  }
+
+#endif // RASTER_X86
+
+  //////////////
+  // dispatch //
+  //////////////
+
+  struct Kernels
+  {
+    Isa isa;
+    void ( *fillSpan )( rgba32*, int, rgba32 );
+    void ( *blendSpan )( rgba32*, int, rgba32 );
+    void ( *blendMaskSpan )( rgba32*, uint8_t const*, int, rgba32 );
+  };
+
+  static constexpr Kernels s_Scalar{ Isa::Scalar, fillSpanScalar, blendSpanScalar, blendMaskSpanScalar };
+#if RASTER_X86
+  static constexpr Kernels s_Sse2{ Isa::Sse2, fillSpanSse2, blendSpanSse2, blendMaskSpanSse2 };
+  static constexpr Kernels s_Avx2{ Isa::Avx2, fillSpanAvx2, blendSpanAvx2, blendMaskSpanAvx2 };
+#endif
+
+  static Kernels const& kernelsFor( Isa isa )
+  {
+#if RASTER_X86
+    switch( isa )
+    {
+      case Isa::Sse2: return s_Sse2;
+      case Isa::Avx2: return s_Avx2;
+      default: break;
+    }
+#endif
+    return s_Scalar;
+  }
+
+  static Kernels const* s_Kernels = nullptr;
+
+  static Kernels const& kernels()
+  {
+    if( !s_Kernels )
+    {
+      s_Kernels = &kernelsFor( DetectIsa() );
+    }
+    return *s_Kernels;
+  }
+
+  Isa DetectIsa()
+  {
+#if RASTER_X86
+    if( SDL_HasAVX2() )
+    {
+      return Isa::Avx2;
+    }
+    if( SDL_HasSSE2() )
+    {
+      return Isa::Sse2;
+    }
+#endif
+    return Isa::Scalar;
+  }
+
+  void SetIsa( Isa isa )
+  {
+    if( static_cast<int>( isa ) > static_cast<int>( DetectIsa() ) )
+    {
+      throw std::runtime_error{ std::format( "This CPU doesn't support {}", Name( isa ) ) };
+    }
+    s_Kernels = &kernelsFor( isa );
+  }
+
+  Isa GetIsa()
+  {
+    return kernels().isa;
+  }
+
+  std::string_view Name( Isa isa )
+  {
+    switch( isa )
+    {
+      case Isa::Sse2: return "SSE2";
+      case Isa::Avx2: return "AVX2";
+      default: return "scalar";
+    }
+  }
+
+  void FillSpan( rgba32* dst, int count, rgba32 colour )
+  {
+    kernels().fillSpan( dst, count, colour );
+  }
+
+  void BlendSpan( rgba32* dst, int count, rgba32 colour )
+  {
+    kernels().blendSpan( dst, count, colour );
+  }
+
+  void BlendMaskSpan( rgba32* dst, uint8_t const* mask, int count, rgba32 colour )
+  {
+    kernels().blendMaskSpan( dst, mask, count, colour );
+  }
+
+  //////////////////
+  // corner masks //
+  //////////////////
+
+  CornerMask const& GetCornerMask( int radius )
+  {
+    static std::map<int, CornerMask> s_CornerMasks;
+
+    // early exit: already computed
+    auto it = s_CornerMasks.find( radius );
+    if( it != s_CornerMasks.end() )
+    {
+      return it->second;
+    }
+
+    // 4x4 samples per pixel, against a circle centred on the corner's inner vertex
+    static constexpr int s_Samples = 4;
+    auto const size = static_cast<size_t>( radius ) * radius;
+    CornerMask mask
+    {
+      .radius = radius,
+      .left = std::vector<uint8_t>( size ),
+      .right = std::vector<uint8_t>( size )
+    };
+    auto const r2 = static_cast<double>( radius ) * radius;
+    for( auto y = 0; y < radius; ++y )
+    {
+      for( auto x = 0; x < radius; ++x )
+      {
+        auto inside = 0;
+        for( auto sy = 0; sy < s_Samples; ++sy )
+        {
+          for( auto sx = 0; sx < s_Samples; ++sx )
+          {
+            auto const dx = radius - ( x + ( sx + 0.5 ) / s_Samples );
+            auto const dy = radius - ( y + ( sy + 0.5 ) / s_Samples );
+            inside += dx * dx + dy * dy <= r2;
+          }
+        }
+        auto const coverage = static_cast<uint8_t>( ( inside * 255 + s_Samples * s_Samples / 2 ) / ( s_Samples * s_Samples ) );
+        mask.left.at( y * radius + x ) = coverage;
+        mask.right.at( y * radius + ( radius - 1 - x ) ) = coverage;
+      }
+    }
+    return s_CornerMasks.emplace( radius, std::move( mask ) ).first->second;
+  }
+
+} // namespace Raster
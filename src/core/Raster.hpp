@@ -0,0 +1,56 @@
+// Raster.hpp
+// pixel kernels for software rasterization, vectorized where the CPU allows
+//
+// Every kernel gives bit-identical results whichever instruction set runs it.
+// Blending is SDL_BLENDMODE_BLEND: dst = src * a + dst * ( 1 - a ), with the
+// destination's alpha composited the same way.
+
+#ifndef CORE_RASTER_HPP_INCLUDED
+#define CORE_RASTER_HPP_INCLUDED
+
+#include "rgba32.hpp"
+
+#include<cstdint>
+#include<string_view>
+#include<vector>
+
+namespace Raster
+{
+  enum class Isa
+  {
+    Scalar,
+    Sse2,
+    Avx2
+  };
+
+  // the best instruction set this CPU supports (x86-64 only; scalar elsewhere)
+  Isa DetectIsa();
+
+  // kernels use DetectIsa() unless told otherwise, e.g. to benchmark against scalar.
+  // Throws if the CPU doesn't support 'isa'.
+  void SetIsa( Isa isa );
+  Isa GetIsa();
+  std::string_view Name( Isa isa );
+
+  // write 'colour' over 'count' pixels
+  void FillSpan( rgba32* dst, int count, rgba32 colour );
+
+  // blend 'colour' over 'count' pixels
+  void BlendSpan( rgba32* dst, int count, rgba32 colour );
+
+  // blend 'colour' over 'count' pixels, its alpha scaled by 'mask' (e.g. coverage or a glyph)
+  void BlendMaskSpan( rgba32* dst, uint8_t const* mask, int count, rgba32 colour );
+
+  // anti-aliased coverage of a rounded corner of the given radius, as
+  // 'radius' rows of 'radius' bytes; computed once per radius (UI thread only)
+  struct CornerMask
+  {
+    int radius = 0;
+    std::vector<uint8_t> left;    // top-left corner
+    std::vector<uint8_t> right;   // top-right corner (left, mirrored)
+  };
+  CornerMask const& GetCornerMask( int radius );
+
+} // namespace Raster
+
+#endif
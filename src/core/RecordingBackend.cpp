@@ -0,0 +1,102 @@
+// RecordingBackend.cpp
+
+#include "RenderBackend.hpp"
+#include "Render.hpp"
+#include "RenderThread.hpp"
+
+using Op = CommandList::Op;
+
+static CommandList::LayerId toId( RenderBackend::Layer layer )
+{
+  return static_cast<CommandList::LayerId>( reinterpret_cast<uintptr_t>( layer ) );
+}
+
+RecordingBackend::RecordingBackend( RenderThread& thread )
+  : m_Thread{ thread }
+{ }
+
+void RecordingBackend::ClearScreen()
+{
+  m_List.Add( { .op = Op::ClearScreen } );
+}
+
+void RecordingBackend::Present()
+{
+  m_List.Add( { .op = Op::Present } );
+  m_Thread.Submit( m_List );
+}
+
+void RecordingBackend::DrawRect( Rect r, rgba32 colour )
+{
+  m_List.Add( { .op = Op::DrawRect, .r = r, .colour = colour } );
+}
+
+void RecordingBackend::DrawFilledRect( Rect r, rgba32 colour )
+{
+  m_List.Add( { .op = Op::DrawFilledRect, .r = r, .colour = colour } );
+}
+
+void RecordingBackend::DrawRoundedBox( Rect r, int radius, rgba32 colour )
+{
+  m_List.Add( { .op = Op::DrawRoundedBox, .r = r, .colour = colour, .value = radius } );
+}
+
+void RecordingBackend::DrawText( Rect r, std::string const& s )
+{
+  // cache the glyphs now, so the render thread doesn't have to
+  Render::CacheGlyphs( s );
+  m_List.AddText( r, s );
+}
+
+void RecordingBackend::SetClipRect( Rect clip )
+{
+  m_List.Add( { .op = Op::SetClipRect, .r = clip } );
+}
+
+void RecordingBackend::ResetClipRect()
+{
+  m_List.Add( { .op = Op::ResetClipRect } );
+}
+
+RenderBackend::Layer RecordingBackend::CreateLayer( int w, int h )
+{
+  // early exit: the render thread's backend has no layers
+  if( !m_Thread.SupportsLayers() )
+  {
+    return nullptr;
+  }
+
+  auto const id = ++m_LastLayer;
+  m_List.Add( { .op = Op::CreateLayer, .r = Rect{ .w = w, .h = h }, .layer = id } );
+  return reinterpret_cast<Layer>( static_cast<uintptr_t>( id ) );
+}
+
+void RecordingBackend::DestroyLayer( Layer layer )
+{
+  m_List.Add( { .op = Op::DestroyLayer, .layer = toId( layer ) } );
+}
+
+void RecordingBackend::BeginLayer( Layer layer, Rect origin )
+{
+  m_List.Add( { .op = Op::BeginLayer, .r = origin, .layer = toId( layer ) } );
+}
+
+void RecordingBackend::EndLayer()
+{
+  m_List.Add( { .op = Op::EndLayer } );
+}
+
+void RecordingBackend::ClearLayerRect( Rect r )
+{
+  m_List.Add( { .op = Op::ClearLayerRect, .r = r } );
+}
+
+void RecordingBackend::DrawLayer( Layer layer, Rect src, int x, int y )
+{
+  m_List.Add( { .op = Op::DrawLayer, .r = Rect{ .x = x, .y = y }, .src = src, .layer = toId( layer ) } );
+}
+
+void RecordingBackend::ShiftLayer( Layer src, Layer dst, int dy )
+{
+  m_List.Add( { .op = Op::ShiftLayer, .value = dy, .layer = toId( src ), .dst = toId( dst ) } );
+}
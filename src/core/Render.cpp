@@ -1,13 +1,15 @@
 // Render.cpp
 
 #include "Render.hpp"
+#include "Counters.hpp"
 #include "FontCache.hpp"
+#include "RenderBackend.hpp"
 
 #include<SDL_FontCache/SDL_FontCache.h>
 
 #include<SDL2/SDL.h>
-#include<SDL2/SDL2_gfxPrimitives.h>
 
+#include<algorithm>
 #include<stdexcept>
 #include<map>
 #include<array>
@@ -18,6 +20,8 @@ namespace Render
 {
   static SDL_Renderer* s_Renderer = nullptr;  
   static FontCache s_FontCache{ s_Renderer };
+  static std::unique_ptr<RenderBackend> s_Backend;
+  static std::recursive_mutex s_RendererMutex;
 
   struct FontLoadSpecs
   {
@@ -33,16 +37,53 @@ namespace Render
     FontLoadSpecs{ "Roboto", "./Fonts/Roboto-Black.ttf", 12, rgba32{ .r = 255, .g = 255, .b = 255, .a = 255 }, TTF_STYLE_NORMAL },
   };
 
+  // per font, see FontCache::SetAtlasBudget()
+  static constexpr Uint32 s_GlyphAtlasBudget = 4 * 1024 * 1024;
+
+  struct CachedLayer
+  {
+    RenderBackend::Layer layer = nullptr;
+    Rect size;              // of the owner, when drawn
+    size_t bytes = 0;
+    bool isValid = false;
+    uint64_t lastDrawn = 0; // frame
+
+    // scroll layers only
+    RenderBackend::Layer spare = nullptr;   // to shift into
+    int top = 0;                            // content row at the top of the band
+    std::vector<ContentRows> dirty{};
+    std::vector<ContentRows> strips{};      // to draw this frame
+  };
+
+  static std::map<Key, CachedLayer> s_Layers;
+  static size_t s_LayerBudget = 32 * 1024 * 1024;
+  static LayerCounters s_LayerCounters;
+  static uint64_t s_Frame = 0;
+  static bool s_InLayer = false;
+
+  // the top is the backend's clip rect; a layer has a stack of its own
+  static std::vector<Rect> s_ClipStack;
+  static std::vector<Rect> s_ScreenClipStack;
+
   FC_Font* DefaultFont()
   {
     return s_FontCache.DefaultFont();
   }
 
+  // SDL_FontCache calls this once per glyph drawn
+  static FC_Rect countingRenderCallback( FC_Image* src, FC_Rect* srcrect, FC_Target* dest, float x, float y, float xscale, float yscale )
+  {
+    Counters::Increment( Counters::GlyphsDrawn );
+    return FC_DefaultRenderCallback( src, srcrect, dest, x, y, xscale, yscale );
+  }
+
   void Init( SDL_Renderer* renderer )
   {
     s_Renderer = renderer;
-    SDL_SetRenderDrawBlendMode( s_Renderer, SDL_BLENDMODE_BLEND );
-    
+    s_Backend = std::make_unique<SdlBackend>( s_Renderer );
+    s_FontCache.SetAtlasBudget( s_GlyphAtlasBudget );
+    FC_SetRenderCallback( countingRenderCallback );
+
     for( auto i = 0; i < s_FontLoadSpecs.size(); ++i )
     {
       auto const& specs = s_FontLoadSpecs.at( i );
@@ -50,57 +91,591 @@ namespace Render
     }
   }
 
+  // layers belong to the backend that created them
+  static void dropLayers()
+  {
+    for( auto const& [ owner, cached ] : s_Layers )
+    {
+      s_Backend->DestroyLayer( cached.layer );
+      if( cached.spare )
+      {
+        s_Backend->DestroyLayer( cached.spare );
+      }
+    }
+    s_Layers.clear();
+    s_LayerCounters.bytes = 0;
+    s_LayerCounters.layers = 0;
+  }
+
+  std::unique_ptr<RenderBackend> SetBackend( std::unique_ptr<RenderBackend> backend )
+  {
+    if( !backend )
+    {
+      throw std::runtime_error{ "Render::SetBackend() given no backend" };
+    }
+    if( s_Backend )
+    {
+      dropLayers();
+    }
+    std::swap( s_Backend, backend );
+    return backend;
+  }
+
+  RenderBackend& GetBackend()
+  {
+    return *s_Backend;
+  }
+
+  SDL_Renderer* GetRenderer()
+  {
+    return s_Renderer;
+  }
+
+  std::unique_lock<std::recursive_mutex> LockRenderer()
+  {
+    return std::unique_lock{ s_RendererMutex };
+  }
+
+  //////////////
+  // CLIPPING //
+  //////////////
+
+  static Rect intersect( Rect a, Rect b )
+  {
+    auto const x0 = std::max( a.x, b.x );
+    auto const y0 = std::max( a.y, b.y );
+    auto const x1 = std::min( a.x + a.w, b.x + b.w );
+    auto const y1 = std::min( a.y + a.h, b.y + b.h );
+    return Rect{ .x = x0, .y = y0, .w = std::max( x1 - x0, 0 ), .h = std::max( y1 - y0, 0 ) };
+  }
+
+  static void applyClip()
+  {
+    if( s_ClipStack.empty() )
+    {
+      s_Backend->ResetClipRect();
+      return;
+    }
+    s_Backend->SetClipRect( s_ClipStack.back() );
+  }
+
+  void PushClipRect( Rect clip )
+  {
+    if( s_ClipStack.size() )
+    {
+      clip = intersect( clip, s_ClipStack.back() );
+    }
+    s_ClipStack.push_back( clip );
+    applyClip();
+  }
+
+  void PopClipRect()
+  {
+    if( s_ClipStack.empty() )
+    {
+      throw std::runtime_error{ "Render::PopClipRect() called with no clip rect pushed" };
+    }
+    s_ClipStack.pop_back();
+    applyClip();
+  }
+
+  bool IsVisible( Rect r )
+  {
+    // early exit: unclipped
+    if( s_ClipStack.empty() )
+    {
+      return true;
+    }
+
+    // early exit: nothing shows through
+    auto const& clip = s_ClipStack.back();
+    if( clip.w <= 0 || clip.h <= 0 )
+    {
+      return false;
+    }
+
+    return r.x <= clip.x + clip.w - 1 && clip.x <= r.x + r.w
+        && r.y <= clip.y + clip.h - 1 && clip.y <= r.y + r.h;
+  }
+
+  // count draws that IsVisible() rejects
+  static bool culled( Rect r )
+  {
+    if( IsVisible( r ) )
+    {
+      return false;
+    }
+    Counters::Increment( Counters::CulledDraws );
+    return true;
+  }
+
+  // layers are clipped to their own bounds, not the screen's clip
+  static void enterLayer( Rect bounds )
+  {
+    s_ScreenClipStack = std::move( s_ClipStack );
+    s_ClipStack = { bounds };
+    applyClip();
+  }
+
+  static void leaveLayer()
+  {
+    s_ClipStack = std::move( s_ScreenClipStack );
+    s_ScreenClipStack.clear();
+    applyClip();
+  }
+
+  /////////////
+  // DRAWING //
+  /////////////
+
   void DrawRect( Rect r, rgba32 colour )
   {
-    SDL_Rect dst = { .x = r.x, .y = r.y, .w = r.w, .h = r.h };
-    SDL_SetRenderDrawColor( s_Renderer, colour.r, colour.g, colour.b, colour.a );
-    SDL_RenderDrawRect( s_Renderer, &dst );
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+    s_Backend->DrawRect( r, colour );
+    Counters::Increment( Counters::DrawCalls );
   }
 
   void DrawFilledRect( Rect r, rgba32 colour )
   {
-    SDL_Rect dst = { .x = r.x, .y = r.y, .w = r.w, .h = r.h };
-    SDL_SetRenderDrawColor( s_Renderer, colour.r, colour.g, colour.b, colour.a );
-    SDL_RenderFillRect( s_Renderer, &dst );
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+    s_Backend->DrawFilledRect( r, colour );
+    Counters::Increment( Counters::DrawCalls );
   }
 
   int CalcTextHeight( Rect r, std::string const& s )
   {
-    SDL_Rect dst{ .x = r.x, .y = r.y, .w = r.w, .h = r.h };
-    return FC_CalcRequiredHeight( DefaultFont(), s_Renderer, dst, FC_ALIGN_LEFT, "%s", s.c_str() );
+    auto renderer = LockRenderer();
+    FC_MeasureContext ctx;
+    FC_InitMeasureContext( &ctx );
+    auto h = MeasureTextHeight( ctx, r.w, s );
+
+    // early exit: all glyphs were cached
+    if( ctx.num_missing == 0 )
+    {
+      return h;
+    }
+
+    // cache the missing glyphs, then measure again
+    CacheGlyphs( s );
+    FC_InitMeasureContext( &ctx );
+    return MeasureTextHeight( ctx, r.w, s );
   }
 
-  void DrawText( Rect r, std::string const& s )
+  int MeasureTextHeight( FC_MeasureContext& ctx, int width, std::string_view s )
   {
-    SDL_Rect dst{ .x = r.x, .y = r.y, .w = r.w, .h = r.h };
-    FC_DrawBoxAlign( DefaultFont(), s_Renderer, dst, FC_ALIGN_LEFT, "%s", s.c_str() );
+    return FC_MeasureColumnHeight( DefaultFont(), &ctx, width, s.data(), s.size() );
   }
 
-  void DrawRoundedBox( Rect r, int radius, rgba32 colour )
+  void CacheGlyphs( std::string_view s )
   {
-    roundedBoxRGBA( s_Renderer, r.x, r.y, r.x + r.w, r.y + r.h, radius, colour.r, colour.g, colour.b, colour.a );
+    auto renderer = LockRenderer();
+    FC_CacheGlyphs( DefaultFont(), s.data(), s.size() );
   }
 
-  void SetClipRect( Rect clip )
+  int MeasureTextLines( int width, std::string_view s, std::vector<uint16_t>& lineWidths )
   {
-    SDL_Rect sdlCLip = { clip.x, clip.y, clip.w, clip.h };
-    SDL_RenderSetClipRect( s_Renderer, &sdlCLip );
+    auto renderer = LockRenderer();
+    CacheGlyphs( s );
+
+    // measure into the existing capacity; if there are more lines, grow and measure again
+    lineWidths.resize( std::max<size_t>( lineWidths.capacity(), 8 ) );
+    FC_MeasureContext ctx;
+    FC_InitMeasureContext( &ctx );
+    auto const numLines = FC_MeasureLineWidths( DefaultFont(), &ctx, width, s.data(), s.size(), lineWidths.data(), static_cast<int>( lineWidths.size() ) );
+    if( static_cast<size_t>( numLines ) > lineWidths.size() )
+    {
+      lineWidths.resize( numLines );
+      FC_InitMeasureContext( &ctx );
+      FC_MeasureLineWidths( DefaultFont(), &ctx, width, s.data(), s.size(), lineWidths.data(), numLines );
+    }
+    lineWidths.resize( numLines );
+    return FC_GetLineHeight( DefaultFont() );
   }
 
-  void ResetClipRect()
+  void DrawText( Rect r, std::string const& s )
   {
-    SDL_RenderSetClipRect( s_Renderer, NULL );
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+    s_Backend->DrawText( r, s );
+    Counters::Increment( Counters::DrawCalls );
+  }
+
+  void DrawRoundedBox( Rect r, int radius, rgba32 colour )
+  {
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+    s_Backend->DrawRoundedBox( r, radius, colour );
+    Counters::Increment( Counters::DrawCalls );
   }
 
   void ClearScreen()
   {
-    SDL_SetRenderDrawColor( s_Renderer, 0, 0, 0, 255 );
-    SDL_RenderClear( s_Renderer );
+    s_Backend->ClearScreen();
   }
 
   void Present()
   {
-    SDL_RenderPresent( s_Renderer );
+    s_Backend->Present();
+    {
+      auto renderer = LockRenderer();
+      s_FontCache.NextFrame();
+    }
+    ++s_Frame;
+  }
+
+  void SetGlyphAtlasBudget( Uint32 bytesPerFont )
+  {
+    auto renderer = LockRenderer();
+    s_FontCache.SetAtlasBudget( bytesPerFont );
+  }
+
+  GlyphAtlasCounters GetGlyphAtlasCounters()
+  {
+    auto renderer = LockRenderer();
+    return s_FontCache.AtlasCounters();
+  }
+
+  //////////////////////
+  // OFFSCREEN LAYERS //
+  //////////////////////
+
+  static void destroyLayer( std::map<Key, CachedLayer>::iterator it )
+  {
+    s_Backend->DestroyLayer( it->second.layer );
+    if( it->second.spare )
+    {
+      s_Backend->DestroyLayer( it->second.spare );
+    }
+    s_LayerCounters.bytes -= it->second.bytes;
+    s_LayerCounters.layers--;
+    s_Layers.erase( it );
+  }
+
+  // evict the least recently drawn layers until 'bytes' more fit in the budget,
+  // but not those drawn this frame: they'd only be redrawn next frame
+  static bool makeRoom( size_t bytes )
+  {
+    while( s_LayerCounters.bytes + bytes > s_LayerBudget )
+    {
+      auto lru = s_Layers.end();
+      for( auto it = s_Layers.begin(); it != s_Layers.end(); ++it )
+      {
+        if( it->second.lastDrawn != s_Frame
+         && ( lru == s_Layers.end() || it->second.lastDrawn < lru->second.lastDrawn ) )
+        {
+          lru = it;
+        }
+      }
+
+      // early exit: nothing left to evict
+      if( lru == s_Layers.end() )
+      {
+        return false;
+      }
+      destroyLayer( lru );
+      s_LayerCounters.evictions++;
+    }
+    return true;
+  }
+
+  bool DrawLayer( Key owner, Rect r )
+  {
+    // early exit: not cached, or stale
+    auto it = s_Layers.find( owner );
+    if( it == s_Layers.end()
+     || !it->second.isValid
+     || it->second.size.w != r.w
+     || it->second.size.h != r.h )
+    {
+      return false;
+    }
+
+    it->second.lastDrawn = s_Frame;
+
+    // early exit: clipped out (but still valid)
+    if( culled( r ) )
+    {
+      return true;
+    }
+    s_Backend->DrawLayer( it->second.layer, Rect{ .w = r.w + 1, .h = r.h + 1 }, r.x, r.y );
+    Counters::Increment( Counters::DrawCalls );
+    Counters::Increment( Counters::LayerBlits );
+    return true;
+  }
+
+  bool BeginLayer( Key owner, Rect r )
+  {
+    // early exit: layers don't nest
+    if( s_InLayer )
+    {
+      return false;
+    }
+
+    // a resized owner needs a new layer
+    auto it = s_Layers.find( owner );
+    if( it != s_Layers.end()
+     && ( it->second.size.w != r.w || it->second.size.h != r.h || it->second.spare ) )
+    {
+      destroyLayer( it );
+      it = s_Layers.end();
+    }
+
+    if( it == s_Layers.end() )
+    {
+      // one pixel more each way, for right and bottom edges drawn inclusively (e.g. by SDL2_gfx)
+      auto const w = r.w + 1;
+      auto const h = r.h + 1;
+      auto const bytes = static_cast<size_t>( w ) * h * sizeof( rgba32 );
+
+      // early exit: over budget
+      if( !makeRoom( bytes ) )
+      {
+        return false;
+      }
+
+      // early exit: not supported
+      auto layer = s_Backend->CreateLayer( w, h );
+      if( !layer )
+      {
+        return false;
+      }
+
+      it = s_Layers.emplace( owner, CachedLayer{ .layer = layer, .size = r, .bytes = bytes } ).first;
+      s_LayerCounters.bytes += bytes;
+      s_LayerCounters.layers++;
+    }
+
+    auto const bounds = Rect{ .x = r.x, .y = r.y, .w = r.w + 1, .h = r.h + 1 };
+    s_Backend->BeginLayer( it->second.layer, r );
+    enterLayer( bounds );
+    s_Backend->ClearLayerRect( bounds );
+    s_InLayer = true;
+    return true;
+  }
+
+  void EndLayer( Key owner, Rect r )
+  {
+    s_Backend->EndLayer();
+    leaveLayer();
+    s_InLayer = false;
+
+    auto& cached = s_Layers.at( owner );
+    cached.isValid = true;
+    cached.lastDrawn = s_Frame;
+    Counters::Increment( Counters::LayersDrawn );
+
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+    s_Backend->DrawLayer( cached.layer, Rect{ .w = r.w + 1, .h = r.h + 1 }, r.x, r.y );
+    Counters::Increment( Counters::DrawCalls );
+  }
+
+  // half a viewport above and below
+  static int bandHeight( Rect r )
+  {
+    return 2 * r.h;
+  }
+
+  // add 'rows', clamped to the band, to 'strips', keeping them sorted and disjoint
+  static void addStrip( std::vector<ContentRows>& strips, CachedLayer const& band, int bandH, ContentRows rows )
+  {
+    rows.top = std::max( rows.top, band.top );
+    rows.bottom = std::min( rows.bottom, band.top + bandH );
+
+    // early exit: outside the band
+    if( rows.top >= rows.bottom )
+    {
+      return;
+    }
+
+    auto it = std::lower_bound( strips.begin(), strips.end(), rows.top,
+      [] ( ContentRows const& strip, int top ) { return strip.bottom < top; } );
+    while( it != strips.end() && it->top <= rows.bottom )
+    {
+      rows.top = std::min( rows.top, it->top );
+      rows.bottom = std::max( rows.bottom, it->bottom );
+      it = strips.erase( it );
+    }
+    strips.insert( it, rows );
+  }
+
+  bool ScrollLayer( Key owner, Rect r, int scrollY, std::span<ContentRows const>& strips )
+  {
+    strips = {};
+
+    // early exit: layers don't nest
+    if( s_InLayer )
+    {
+      return false;
+    }
+
+    // a resized viewport needs a new band
+    auto const bandH = bandHeight( r );
+    auto it = s_Layers.find( owner );
+    if( it != s_Layers.end()
+     && ( it->second.size.w != r.w || it->second.size.h != r.h || !it->second.spare ) )
+    {
+      destroyLayer( it );
+      it = s_Layers.end();
+    }
+
+    if( it == s_Layers.end() )
+    {
+      // early exit: over budget
+      auto const bytes = 2 * static_cast<size_t>( r.w ) * bandH * sizeof( rgba32 );
+      if( !makeRoom( bytes ) )
+      {
+        return false;
+      }
+
+      // early exit: not supported
+      auto layer = s_Backend->CreateLayer( r.w, bandH );
+      auto spare = layer ? s_Backend->CreateLayer( r.w, bandH ) : nullptr;
+      if( !spare )
+      {
+        if( layer )
+        {
+          s_Backend->DestroyLayer( layer );
+        }
+        return false;
+      }
+
+      it = s_Layers.emplace( owner, CachedLayer{ .layer = layer, .size = r, .bytes = bytes, .spare = spare } ).first;
+      s_LayerCounters.bytes += bytes;
+      s_LayerCounters.layers++;
+    }
+
+    auto& band = it->second;
+    band.lastDrawn = s_Frame;
+    band.strips.clear();
+    auto const top = scrollY - ( bandH - r.h ) / 2;
+
+    // invalidated: draw it all
+    if( !band.isValid )
+    {
+      band.top = top;
+      band.isValid = true;
+      band.dirty.clear();
+      band.strips.push_back( ContentRows{ top, top + bandH } );
+      strips = band.strips;
+      Counters::Increment( Counters::LayersDrawn );
+      return true;
+    }
+
+    // re-centre the band once the viewport leaves it, keeping the rows both share
+    if( scrollY < band.top || scrollY + r.h > band.top + bandH )
+    {
+      auto const shift = band.top - top;
+      auto const exposed = shift > 0
+        ? ContentRows{ top, std::min( band.top, top + bandH ) }
+        : ContentRows{ std::max( band.top + bandH, top ), top + bandH };
+      if( std::abs( shift ) < bandH )
+      {
+        s_Backend->ShiftLayer( band.layer, band.spare, shift );
+        std::swap( band.layer, band.spare );
+      }
+      band.top = top;
+      addStrip( band.strips, band, bandH, exposed );
+    }
+
+    for( auto const rows : band.dirty )
+    {
+      addStrip( band.strips, band, bandH, rows );
+    }
+    band.dirty.clear();
+    strips = band.strips;
+    return true;
+  }
+
+  void BeginScrollStrip( Key owner, Rect r, int scrollY, ContentRows strip )
+  {
+    // content row c is drawn at screen row r.y + c - scrollY, and band row c - band.top
+    auto const& band = s_Layers.at( owner );
+    auto const y_adjust = r.y - scrollY;
+    auto const rows = Rect{ .x = r.x, .y = strip.top + y_adjust, .w = r.w, .h = strip.bottom - strip.top };
+    s_Backend->BeginLayer( band.layer, Rect{ .x = r.x, .y = band.top + y_adjust } );
+    enterLayer( rows );
+    s_Backend->ClearLayerRect( rows );
+    s_InLayer = true;
+  }
+
+  void EndScrollStrip()
+  {
+    s_Backend->EndLayer();
+    leaveLayer();
+    s_InLayer = false;
+  }
+
+  void DrawScrollLayer( Key owner, Rect r, int scrollY )
+  {
+    // early exit: clipped out
+    if( culled( r ) )
+    {
+      return;
+    }
+
+    auto const& band = s_Layers.at( owner );
+    s_Backend->DrawLayer( band.layer, Rect{ .y = scrollY - band.top, .w = r.w, .h = r.h }, r.x, r.y );
+    Counters::Increment( Counters::DrawCalls );
+    Counters::Increment( Counters::LayerBlits );
+  }
+
+  void InvalidateLayer( Key owner, Rect area )
+  {
+    // early exit: not cached
+    auto it = s_Layers.find( owner );
+    if( it == s_Layers.end() )
+    {
+      return;
+    }
+
+    auto& cached = it->second;
+    if( !cached.spare )
+    {
+      cached.isValid = false;
+      return;
+    }
+
+    // one more row, for bottom edges drawn inclusively; too many strips and it's all dirty
+    static constexpr size_t s_MaxDirty = 32;
+    cached.dirty.push_back( ContentRows{ area.y, area.y + area.h + 1 } );
+    if( cached.dirty.size() > s_MaxDirty )
+    {
+      cached.isValid = false;
+    }
+  }
+
+  bool HasLayers()
+  {
+    return !s_Layers.empty();
+  }
+
+  void SetLayerBudget( size_t bytes )
+  {
+    s_LayerBudget = bytes;
+    makeRoom( 0 );
+  }
+
+  LayerCounters GetLayerCounters()
+  {
+    return s_LayerCounters;
   }
 
 
@@ -4,19 +4,48 @@
 #define RENDER_HPP_INCLUDED
 
 #include "rgba32.hpp"
+#include "FontCache.hpp"
+#include "Key.hpp"
 
 #include<Layout/Layouts.hpp>
 
+#include<memory>
+#include<mutex>
+#include<span>
 #include<string>
+#include<string_view>
+#include<vector>
 
 struct SDL_Renderer;
+struct FC_Font;
+struct FC_MeasureContext;
+class RenderBackend;
+
+struct LayerCounters
+{
+  size_t bytes = 0;
+  int layers = 0;
+  uint64_t evictions = 0;
+};
 
 namespace Render
 {
   using namespace Layouts;
 
+  // loads the fonts, and draws with an SdlBackend until SetBackend() says otherwise
   void Init( SDL_Renderer* renderer );
 
+  // returns the previous backend
+  std::unique_ptr<RenderBackend> SetBackend( std::unique_ptr<RenderBackend> backend );
+  RenderBackend& GetBackend();
+  SDL_Renderer* GetRenderer();
+
+  // the SDL renderer and glyph cache are used by one thread at a time. With a RenderThread,
+  // it holds this while replaying, and Render holds it while caching or measuring glyphs.
+  std::unique_lock<std::recursive_mutex> LockRenderer();
+
+  FC_Font* DefaultFont();
+
   void DrawRect( Rect r, rgba32 colour );
   void DrawFilledRect( Rect r, rgba32 colour );
   void DrawRoundedBox( Rect r, int radius, rgba32 colour );
@@ -24,11 +53,63 @@ namespace Render
 
   int CalcTextHeight( Rect r, std::string const& s );
 
+  // re-entrant measuring: safe to call from several threads at once, as long as nothing
+  // is drawing or caching glyphs meanwhile. Uncached glyphs are measured as spaces and
+  // recorded in 'ctx'; cache them with CacheGlyphs() on the UI thread and measure again.
+  int MeasureTextHeight( FC_MeasureContext& ctx, int width, std::string_view s );
+  void CacheGlyphs( std::string_view s );
+
+  // the widths of the lines DrawText() wraps 's' into; returns the line height (UI thread only)
+  int MeasureTextLines( int width, std::string_view s, std::vector<uint16_t>& lineWidths );
+
   void ClearScreen();
   void Present();
 
-  void SetClipRect( Rect clip );
-  void ResetClipRect();
+  // clip rects nest: each pushed is intersected with the one below it. Draws outside the
+  // current clip are culled here, rather than sent to the backend to be discarded late.
+  void PushClipRect( Rect clip );
+  void PopClipRect();
+
+  // whether anything drawn within 'r' (and its inclusive right and bottom edges) would be seen
+  bool IsVisible( Rect r );
+
+  // glyph atlas memory is bounded per font; least recently used pages are recycled
+  void SetGlyphAtlasBudget( Uint32 bytesPerFont );
+  GlyphAtlasCounters GetGlyphAtlasCounters();
+
+  // offscreen layers cache what a widget subtree draws, keyed by the widget. Layers share a
+  // memory budget; those drawn least recently are evicted to make room for new ones.
+  //
+  // DrawLayer() blits 'owner's layer at 'r', if it's still valid and the same size.
+  // Otherwise, draw between BeginLayer() and EndLayer(), which blits the new layer;
+  // if BeginLayer() returns false (no layer support, or over budget), draw directly.
+  bool DrawLayer( Key owner, Rect r );
+  bool BeginLayer( Key owner, Rect r );
+  void EndLayer( Key owner, Rect r );
+
+  // scroll layers cache a band of a scrolling widget's content, taller than its viewport 'r',
+  // so scrolling only draws the rows it newly exposes. ScrollLayer() moves the band to show
+  // content row 'scrollY' at the top of 'r', keeping the rows it already has, and returns the
+  // rows to draw in 'strips'; draw each between BeginScrollStrip() and EndScrollStrip(), then
+  // blit with DrawScrollLayer(). If it returns false (as BeginLayer()), draw directly.
+  // 'strips' are kept with the owner's layer, so stay put while nested ones are drawn.
+  struct ContentRows
+  {
+    int top;
+    int bottom;   // exclusive
+  };
+  bool ScrollLayer( Key owner, Rect r, int scrollY, std::span<ContentRows const>& strips );
+  void BeginScrollStrip( Key owner, Rect r, int scrollY, ContentRows strip );
+  void EndScrollStrip();
+  void DrawScrollLayer( Key owner, Rect r, int scrollY );
+
+  // what 'owner' drew over 'area' (its layout coordinates) must be drawn again, e.g.
+  // because a state within the subtree changed. Non-scroll layers are drawn again whole.
+  void InvalidateLayer( Key owner, Rect area );
+  bool HasLayers();
+
+  void SetLayerBudget( size_t bytes );
+  LayerCounters GetLayerCounters();
 
 } // namespace Render
 
@@ -0,0 +1,256 @@
+// RenderBackend.hpp
+// where Render's draw commands go: SDL, nowhere, or an in-memory framebuffer
+
+#ifndef CORE_RENDER_BACKEND_HPP_INCLUDED
+#define CORE_RENDER_BACKEND_HPP_INCLUDED
+
+#include "rgba32.hpp"
+#include "CommandList.hpp"
+
+#include<Layout/Layouts.hpp>
+
+#include<cstdint>
+#include<map>
+#include<string>
+#include<vector>
+
+struct SDL_Renderer;
+struct SDL_Texture;
+struct SDL_Vertex;
+class RenderThread;
+
+class RenderBackend
+{
+public:
+  using Rect = Layouts::Rect;
+
+  virtual ~RenderBackend() = default;
+
+  virtual void ClearScreen() = 0;
+  virtual void Present() = 0;
+
+  virtual void DrawRect( Rect r, rgba32 colour ) = 0;
+  virtual void DrawFilledRect( Rect r, rgba32 colour ) = 0;
+  virtual void DrawRoundedBox( Rect r, int radius, rgba32 colour ) = 0;
+  virtual void DrawText( Rect r, std::string const& s ) = 0;
+
+  virtual void SetClipRect( Rect clip ) = 0;
+  virtual void ResetClipRect() = 0;
+
+  // may a thread other than its creator's draw with it (under Render::LockRenderer())?
+  virtual bool IsThreadSafe() const { return true; }
+
+  // offscreen layers, for caching what a widget subtree draws. Backends without
+  // them return nullptr from CreateLayer(), and the subtree is drawn directly.
+  using Layer = void*;
+  virtual Layer CreateLayer( int w, int h ) { return nullptr; }
+  virtual void DestroyLayer( Layer layer ) {}
+
+  // draw into 'layer', with (origin.x, origin.y) at its top left, until EndLayer()
+  virtual void BeginLayer( Layer layer, Rect origin ) {}
+  virtual void EndLayer() {}
+
+  // make 'r' transparent in the layer being drawn
+  virtual void ClearLayerRect( Rect r ) {}
+
+  // blit 'src' of 'layer' 1:1 with its top left at (x, y)
+  virtual void DrawLayer( Layer layer, Rect src, int x, int y ) {}
+
+  // copy 'src' into 'dst' (of the same size), moved down 'dy' rows; uncovered rows are transparent
+  virtual void ShiftLayer( Layer src, Layer dst, int dy ) {}
+};
+
+////////////////
+// SdlBackend //
+////////////////
+
+// SDL2 and SDL_FontCache: the default
+//
+// Rounded boxes are nine-slices of a cached, anti-aliased white texture per
+// radius, tinted by vertex colour. Consecutive boxes of the same radius are
+// batched into one SDL_RenderGeometry() call, flushed by any other command.
+// With 'nineSliceBoxes' false, boxes are drawn by SDL2_gfx instead.
+//
+// Layers are target textures. What's drawn into them is blended over transparency,
+// leaving premultiplied colour, so they're blitted with a premultiplied blend mode.
+// Renderers without custom blend modes (e.g. SDL's software renderer) have no layers.
+class SdlBackend : public RenderBackend
+{
+private:
+  SDL_Renderer* m_Renderer;
+  bool m_NineSliceBoxes;
+  std::map<int, SDL_Texture*> m_BoxTextures;   // by radius
+
+  // pending rounded boxes
+  SDL_Texture* m_BatchTexture = nullptr;
+  std::vector<SDL_Vertex> m_BatchVertices;
+  std::vector<int> m_BatchIndices;
+
+  // while drawing into a layer, its top left in screen coordinates
+  int m_OriginX = 0;
+  int m_OriginY = 0;
+
+public:
+  explicit SdlBackend( SDL_Renderer* renderer, bool nineSliceBoxes = true );
+  ~SdlBackend();
+
+  SdlBackend( SdlBackend const& ) = delete;
+  SdlBackend& operator=( SdlBackend const& ) = delete;
+
+  void ClearScreen() override;
+  void Present() override;
+
+  void DrawRect( Rect r, rgba32 colour ) override;
+  void DrawFilledRect( Rect r, rgba32 colour ) override;
+  void DrawRoundedBox( Rect r, int radius, rgba32 colour ) override;
+  void DrawText( Rect r, std::string const& s ) override;
+
+  void SetClipRect( Rect clip ) override;
+  void ResetClipRect() override;
+
+  // software and Direct3D only: OpenGL contexts are bound to their creator's thread
+  bool IsThreadSafe() const override;
+
+  Layer CreateLayer( int w, int h ) override;
+  void DestroyLayer( Layer layer ) override;
+  void BeginLayer( Layer layer, Rect origin ) override;
+  void EndLayer() override;
+  void ClearLayerRect( Rect r ) override;
+  void DrawLayer( Layer layer, Rect src, int x, int y ) override;
+  void ShiftLayer( Layer src, Layer dst, int dy ) override;
+
+private:
+  Rect toTarget( Rect r ) const;
+  SDL_Texture* boxTexture( int radius );
+  void flushBatch();
+};
+
+/////////////////
+// NullBackend //
+/////////////////
+
+// draws nothing: counts commands and throws on malformed ones,
+// so the engine can be benchmarked without any rasterization
+class NullBackend : public RenderBackend
+{
+public:
+  struct Stats
+  {
+    uint64_t clears = 0;
+    uint64_t presents = 0;
+    uint64_t rects = 0;
+    uint64_t filledRects = 0;
+    uint64_t roundedBoxes = 0;
+    uint64_t texts = 0;
+    uint64_t textBytes = 0;
+    uint64_t clipChanges = 0;
+  };
+
+private:
+  Stats m_Stats;
+  bool m_InFrame = false;
+
+public:
+  void ClearScreen() override;
+  void Present() override;
+
+  void DrawRect( Rect r, rgba32 colour ) override;
+  void DrawFilledRect( Rect r, rgba32 colour ) override;
+  void DrawRoundedBox( Rect r, int radius, rgba32 colour ) override;
+  void DrawText( Rect r, std::string const& s ) override;
+
+  void SetClipRect( Rect clip ) override;
+  void ResetClipRect() override;
+
+  Stats const& GetStats() const;
+
+private:
+  void validate( Rect r, char const* command ) const;
+};
+
+/////////////////////
+// SoftwareBackend //
+/////////////////////
+
+// rasterizes into an RGBA framebuffer in memory, for golden images and
+// GPU-free measurements. Text is drawn as one solid bar per wrapped line,
+// so images don't depend on how the font rasterizer anti-aliases glyphs.
+class SoftwareBackend : public RenderBackend
+{
+private:
+  int m_Width;
+  int m_Height;
+  std::vector<rgba32> m_Pixels;
+  Rect m_Clip;
+  std::vector<uint16_t> m_LineWidths;   // scratch for DrawText()
+
+public:
+  SoftwareBackend( int width, int height );
+
+  void ClearScreen() override;
+  void Present() override;
+
+  void DrawRect( Rect r, rgba32 colour ) override;
+  void DrawFilledRect( Rect r, rgba32 colour ) override;
+  void DrawRoundedBox( Rect r, int radius, rgba32 colour ) override;
+  void DrawText( Rect r, std::string const& s ) override;
+
+  void SetClipRect( Rect clip ) override;
+  void ResetClipRect() override;
+
+  // blend 'tint' through an 8-bit alpha mask (e.g. a glyph) of 'w' x 'h', 'stride' bytes per row
+  void DrawMask( int x, int y, int w, int h, uint8_t const* mask, int stride, rgba32 tint );
+
+  int Width() const;
+  int Height() const;
+  rgba32 GetPixel( int x, int y ) const;
+  std::vector<rgba32> const& Pixels() const;
+
+  // binary PPM (alpha dropped); throws on failure
+  void SavePpm( std::string const& path ) const;
+
+private:
+  // blend 'colour' over [x0, x1) on row y, within the clip rect
+  void blendSpan( int y, int x0, int x1, rgba32 colour );
+
+  // ... with its alpha scaled by 'mask', for the 'count' pixels from x
+  void blendMaskSpan( int y, int x, uint8_t const* mask, int count, rgba32 colour );
+};
+
+//////////////////////
+// RecordingBackend //
+//////////////////////
+
+// records commands for a RenderThread to replay, submitting them on Present().
+// Layers are handed out as ids, which the render thread maps to its own.
+class RecordingBackend : public RenderBackend
+{
+private:
+  RenderThread& m_Thread;
+  CommandList m_List;
+  CommandList::LayerId m_LastLayer = 0;
+
+public:
+  explicit RecordingBackend( RenderThread& thread );
+
+  void ClearScreen() override;
+  void Present() override;
+
+  void DrawRect( Rect r, rgba32 colour ) override;
+  void DrawFilledRect( Rect r, rgba32 colour ) override;
+  void DrawRoundedBox( Rect r, int radius, rgba32 colour ) override;
+  void DrawText( Rect r, std::string const& s ) override;
+
+  void SetClipRect( Rect clip ) override;
+  void ResetClipRect() override;
+
+  Layer CreateLayer( int w, int h ) override;
+  void DestroyLayer( Layer layer ) override;
+  void BeginLayer( Layer layer, Rect origin ) override;
+  void EndLayer() override;
+  void ClearLayerRect( Rect r ) override;
+  void DrawLayer( Layer layer, Rect src, int x, int y ) override;
+  void ShiftLayer( Layer src, Layer dst, int dy ) override;
+};
+
+#endif
@@ -0,0 +1,133 @@
+// RenderThread.cpp
+
+#include "RenderThread.hpp"
+#include "Profiler.hpp"
+#include "Render.hpp"
+#include "RenderBackend.hpp"
+
+#include<stdexcept>
+
+RenderThread::~RenderThread()
+{
+  if( m_Thread.joinable() )
+  {
+    Stop();
+  }
+}
+
+void RenderThread::Start( std::unique_ptr<RenderBackend> target )
+{
+  if( m_Thread.joinable() )
+  {
+    throw std::runtime_error{ "RenderThread::Start() called twice" };
+  }
+
+  // can the target draw layers? Ask before there's another thread to ask from
+  m_Target = std::move( target );
+  if( auto probe = m_Target->CreateLayer( 1, 1 ) )
+  {
+    m_Target->DestroyLayer( probe );
+    m_SupportsLayers = true;
+  }
+
+  m_Stopping = false;
+  m_Thread = std::thread{ [ this ] { run(); } };
+}
+
+std::unique_ptr<RenderBackend> RenderThread::Stop()
+{
+  {
+    std::lock_guard lock{ m_Mutex };
+    m_Stopping = true;
+  }
+  m_Changed.notify_all();
+  m_Thread.join();
+
+  // layers that outlived the lists
+  for( auto const& [ id, layer ] : m_Layers )
+  {
+    if( layer )
+    {
+      m_Target->DestroyLayer( layer );
+    }
+  }
+  m_Layers.clear();
+  return std::move( m_Target );
+}
+
+bool RenderThread::SupportsLayers() const
+{
+  return m_SupportsLayers;
+}
+
+void RenderThread::SetInputTime( Clock::time_point inputTime )
+{
+  m_InputTime = inputTime;
+}
+
+void RenderThread::Submit( CommandList& list )
+{
+  list.inputTime = m_InputTime;
+  {
+    std::unique_lock lock{ m_Mutex };
+    m_Changed.wait( lock, [ this ] { return !m_Waiting || m_Error; } );
+    if( m_Error )
+    {
+      std::rethrow_exception( m_Error );
+    }
+
+    m_Waiting.emplace( std::move( list ) );
+    if( m_Recycled.size() )
+    {
+      list = std::move( m_Recycled.back() );
+      m_Recycled.pop_back();
+    }
+  }
+  m_Changed.notify_all();
+  list.Clear();
+}
+
+double RenderThread::LatencyMs() const
+{
+  return m_LatencyMs.load( std::memory_order_relaxed );
+}
+
+void RenderThread::run()
+{
+  DRUI_PROFILE_THREAD( "render" );
+  while( true )
+  {
+    // wait for a list; finish those waiting before stopping
+    CommandList list;
+    {
+      std::unique_lock lock{ m_Mutex };
+      m_Changed.wait( lock, [ this ] { return m_Waiting || m_Stopping; } );
+      if( !m_Waiting )
+      {
+        return;
+      }
+      list = std::move( *m_Waiting );
+      m_Waiting.reset();
+    }
+    m_Changed.notify_all();
+
+    try
+    {
+      DRUI_PROFILE_SCOPE( "Replay" );
+      auto renderer = Render::LockRenderer();
+      list.Replay( *m_Target, m_Layers );
+    }
+    catch( ... )
+    {
+      std::lock_guard lock{ m_Mutex };
+      m_Error = std::current_exception();
+      m_Changed.notify_all();
+      return;
+    }
+    m_LatencyMs.store( std::chrono::duration<double, std::milli>( Clock::now() - list.inputTime ).count(), std::memory_order_relaxed );
+
+    // recycle: the UI thread records into it next
+    std::lock_guard lock{ m_Mutex };
+    m_Recycled.push_back( std::move( list ) );
+  }
+}
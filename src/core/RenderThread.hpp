@@ -0,0 +1,79 @@
+// RenderThread.hpp
+// replays the UI thread's command lists onto the real backend, and presents
+//
+// Lists are triple buffered: the UI thread records one while another waits and the
+// render thread replays a third. Submit() blocks while a list is still waiting,
+// as every frame's layer commands must run, so frames can't be dropped.
+//
+// SDL renderers aren't meant to be shared between threads. Each use is serialized by
+// Render::LockRenderer(), which suffices for the Direct3D and software renderers, but
+// not OpenGL, whose context is current only on the thread that created it; so
+// Application::UseRenderThread() declines unless the backend IsThreadSafe().
+
+#ifndef CORE_RENDER_THREAD_HPP_INCLUDED
+#define CORE_RENDER_THREAD_HPP_INCLUDED
+
+#include "CommandList.hpp"
+
+#include<atomic>
+#include<condition_variable>
+#include<exception>
+#include<memory>
+#include<mutex>
+#include<optional>
+#include<thread>
+#include<vector>
+
+class RenderBackend;
+
+class RenderThread
+{
+public:
+  using Clock = CommandList::Clock;
+
+private:
+  std::unique_ptr<RenderBackend> m_Target;
+  bool m_SupportsLayers = false;
+  CommandList::LayerMap m_Layers;   // render thread only
+  Clock::time_point m_InputTime;    // UI thread only
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Changed;
+  std::optional<CommandList> m_Waiting;
+  std::vector<CommandList> m_Recycled;
+  std::exception_ptr m_Error;
+  bool m_Stopping = false;
+
+  std::atomic<double> m_LatencyMs{ 0.0 };
+  std::thread m_Thread;
+
+public:
+  RenderThread() = default;
+  ~RenderThread();
+
+  RenderThread( RenderThread const& ) = delete;
+  RenderThread& operator=( RenderThread const& ) = delete;
+
+  // take over 'target' (e.g. the backend Render was drawing with), and start replaying
+  void Start( std::unique_ptr<RenderBackend> target );
+
+  // finish the lists submitted so far, then give back the target
+  std::unique_ptr<RenderBackend> Stop();
+
+  bool SupportsLayers() const;
+
+  // stamp the next list submitted
+  void SetInputTime( Clock::time_point inputTime );
+
+  // hand over a recorded frame, and swap in an empty list to record the next.
+  // Rethrows anything the render thread threw.
+  void Submit( CommandList& list );
+
+  // input to present, of the latest frame presented
+  double LatencyMs() const;
+
+private:
+  void run();
+};
+
+#endif
@@ -0,0 +1,307 @@
+// SdlBackend.cpp
+
+#include "RenderBackend.hpp"
+#include "Counters.hpp"
+#include "Raster.hpp"
+#include "Render.hpp"
+
+#include<SDL_FontCache/SDL_FontCache.h>
+
+#include<SDL2/SDL.h>
+#include<SDL2/SDL2_gfxPrimitives.h>
+
+#include<algorithm>
+#include<array>
+#include<format>
+#include<stdexcept>
+#include<string_view>
+
+SdlBackend::SdlBackend( SDL_Renderer* renderer, bool nineSliceBoxes )
+  : m_Renderer{ renderer },
+    m_NineSliceBoxes{ nineSliceBoxes }
+{
+  SDL_SetRenderDrawBlendMode( m_Renderer, SDL_BLENDMODE_BLEND );
+}
+
+SdlBackend::~SdlBackend()
+{
+  for( auto const& [ radius, texture ] : m_BoxTextures )
+  {
+    SDL_DestroyTexture( texture );
+  }
+}
+
+void SdlBackend::ClearScreen()
+{
+  flushBatch();
+  SDL_SetRenderDrawColor( m_Renderer, 0, 0, 0, 255 );
+  SDL_RenderClear( m_Renderer );
+}
+
+void SdlBackend::Present()
+{
+  flushBatch();
+  SDL_RenderPresent( m_Renderer );
+}
+
+void SdlBackend::DrawRect( Rect r, rgba32 colour )
+{
+  flushBatch();
+  r = toTarget( r );
+  SDL_Rect dst = { .x = r.x, .y = r.y, .w = r.w, .h = r.h };
+  SDL_SetRenderDrawColor( m_Renderer, colour.r, colour.g, colour.b, colour.a );
+  SDL_RenderDrawRect( m_Renderer, &dst );
+}
+
+void SdlBackend::DrawFilledRect( Rect r, rgba32 colour )
+{
+  flushBatch();
+  r = toTarget( r );
+  SDL_Rect dst = { .x = r.x, .y = r.y, .w = r.w, .h = r.h };
+  SDL_SetRenderDrawColor( m_Renderer, colour.r, colour.g, colour.b, colour.a );
+  SDL_RenderFillRect( m_Renderer, &dst );
+}
+
+void SdlBackend::DrawRoundedBox( Rect r, int radius, rgba32 colour )
+{
+  r = toTarget( r );
+
+  // early exit: SDL2_gfx
+  if( !m_NineSliceBoxes )
+  {
+    roundedBoxRGBA( m_Renderer, r.x, r.y, r.x + r.w, r.y + r.h, radius, colour.r, colour.g, colour.b, colour.a );
+    return;
+  }
+
+  // covers the same pixels as roundedBoxRGBA(), whose corners are inclusive
+  auto const w = r.w + 1;
+  auto const h = r.h + 1;
+  radius = std::clamp( radius, 0, std::min( w, h ) / 2 );
+
+  // boxes of another radius need another texture
+  auto texture = boxTexture( radius );
+  if( texture != m_BatchTexture )
+  {
+    flushBatch();
+    m_BatchTexture = texture;
+  }
+
+  // 4 x 4 vertices: the edges of the corners and the stretched middle
+  auto const size = static_cast<float>( 2 * radius + 1 );
+  std::array const xs = { float( r.x ), float( r.x + radius ), float( r.x + w - radius ), float( r.x + w ) };
+  std::array const ys = { float( r.y ), float( r.y + radius ), float( r.y + h - radius ), float( r.y + h ) };
+  std::array const uvs = { 0.0f, radius / size, ( radius + 1 ) / size, 1.0f };
+  auto const first = static_cast<int>( m_BatchVertices.size() );
+  for( auto j = 0; j < 4; ++j )
+  {
+    for( auto i = 0; i < 4; ++i )
+    {
+      m_BatchVertices.push_back( SDL_Vertex
+        {
+          .position = { xs[ i ], ys[ j ] },
+          .color = { colour.r, colour.g, colour.b, colour.a },
+          .tex_coord = { uvs[ i ], uvs[ j ] }
+        }
+      );
+    }
+  }
+
+  // nine quads, two triangles each
+  for( auto j = 0; j < 3; ++j )
+  {
+    for( auto i = 0; i < 3; ++i )
+    {
+      auto const v = first + j * 4 + i;
+      m_BatchIndices.insert( m_BatchIndices.end(), { v, v + 1, v + 4, v + 1, v + 5, v + 4 } );
+    }
+  }
+}
+
+void SdlBackend::DrawText( Rect r, std::string const& s )
+{
+  flushBatch();
+  r = toTarget( r );
+  SDL_Rect dst{ .x = r.x, .y = r.y, .w = r.w, .h = r.h };
+  FC_DrawBoxAlign( Render::DefaultFont(), m_Renderer, dst, FC_ALIGN_LEFT, "%s", s.c_str() );
+}
+
+void SdlBackend::SetClipRect( Rect clip )
+{
+  flushBatch();
+  clip = toTarget( clip );
+  SDL_Rect sdlCLip = { clip.x, clip.y, clip.w, clip.h };
+  SDL_RenderSetClipRect( m_Renderer, &sdlCLip );
+}
+
+void SdlBackend::ResetClipRect()
+{
+  flushBatch();
+  SDL_RenderSetClipRect( m_Renderer, NULL );
+}
+
+bool SdlBackend::IsThreadSafe() const
+{
+  // early exit: unknown
+  SDL_RendererInfo info;
+  if( SDL_GetRendererInfo( m_Renderer, &info ) != 0 )
+  {
+    return false;
+  }
+
+  static constexpr std::array<std::string_view, 4> s_ThreadSafe = { "software", "direct3d", "direct3d11", "direct3d12" };
+  return std::ranges::find( s_ThreadSafe, std::string_view{ info.name } ) != s_ThreadSafe.end();
+}
+
+RenderBackend::Layer SdlBackend::CreateLayer( int w, int h )
+{
+  // early exit: no render targets
+  if( !SDL_RenderTargetSupported( m_Renderer ) )
+  {
+    return nullptr;
+  }
+
+  // early exit: e.g. out of texture memory
+  auto texture = SDL_CreateTexture( m_Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h );
+  if( !texture )
+  {
+    return nullptr;
+  }
+
+  // early exit: the renderer can't blend premultiplied colour
+  auto const premultiplied = SDL_ComposeCustomBlendMode(
+    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD );
+  if( SDL_SetTextureBlendMode( texture, premultiplied ) != 0 )
+  {
+    SDL_DestroyTexture( texture );
+    return nullptr;
+  }
+  return texture;
+}
+
+void SdlBackend::DestroyLayer( Layer layer )
+{
+  SDL_DestroyTexture( static_cast<SDL_Texture*>( layer ) );
+}
+
+void SdlBackend::BeginLayer( Layer layer, Rect origin )
+{
+  // NB: SDL restores the screen's clip rect when the target is reset
+  flushBatch();
+  SDL_SetRenderTarget( m_Renderer, static_cast<SDL_Texture*>( layer ) );
+  m_OriginX = origin.x;
+  m_OriginY = origin.y;
+}
+
+void SdlBackend::EndLayer()
+{
+  flushBatch();
+  SDL_SetRenderTarget( m_Renderer, nullptr );
+  m_OriginX = 0;
+  m_OriginY = 0;
+}
+
+void SdlBackend::ClearLayerRect( Rect r )
+{
+  flushBatch();
+  r = toTarget( r );
+  SDL_Rect dst{ .x = r.x, .y = r.y, .w = r.w, .h = r.h };
+  SDL_SetRenderDrawBlendMode( m_Renderer, SDL_BLENDMODE_NONE );
+  SDL_SetRenderDrawColor( m_Renderer, 0, 0, 0, 0 );
+  SDL_RenderFillRect( m_Renderer, &dst );
+  SDL_SetRenderDrawBlendMode( m_Renderer, SDL_BLENDMODE_BLEND );
+}
+
+void SdlBackend::DrawLayer( Layer layer, Rect src, int x, int y )
+{
+  flushBatch();
+  auto const target = toTarget( Rect{ .x = x, .y = y } );
+  SDL_Rect srcRect{ .x = src.x, .y = src.y, .w = src.w, .h = src.h };
+  SDL_Rect dstRect{ .x = target.x, .y = target.y, .w = src.w, .h = src.h };
+  SDL_RenderCopy( m_Renderer, static_cast<SDL_Texture*>( layer ), &srcRect, &dstRect );
+}
+
+void SdlBackend::ShiftLayer( Layer src, Layer dst, int dy )
+{
+  flushBatch();
+  auto srcTexture = static_cast<SDL_Texture*>( src );
+  auto dstTexture = static_cast<SDL_Texture*>( dst );
+  SDL_Rect dstRect{ .y = dy };
+  SDL_QueryTexture( srcTexture, nullptr, nullptr, &dstRect.w, &dstRect.h );
+
+  // copy, rather than blend
+  SDL_BlendMode blendMode;
+  SDL_GetTextureBlendMode( srcTexture, &blendMode );
+  SDL_SetTextureBlendMode( srcTexture, SDL_BLENDMODE_NONE );
+
+  auto const previous = SDL_GetRenderTarget( m_Renderer );
+  SDL_SetRenderTarget( m_Renderer, dstTexture );
+  SDL_SetRenderDrawColor( m_Renderer, 0, 0, 0, 0 );
+  SDL_RenderClear( m_Renderer );
+  SDL_RenderCopy( m_Renderer, srcTexture, nullptr, &dstRect );
+  SDL_SetRenderTarget( m_Renderer, previous );
+
+  SDL_SetTextureBlendMode( srcTexture, blendMode );
+}
+
+Layouts::Rect SdlBackend::toTarget( Rect r ) const
+{
+  return r.WithTransform( -m_OriginX, -m_OriginY );
+}
+
+SDL_Texture* SdlBackend::boxTexture( int radius )
+{
+  // early exit: cached
+  auto it = m_BoxTextures.find( radius );
+  if( it != m_BoxTextures.end() )
+  {
+    return it->second;
+  }
+
+  // white, with the corners' coverage as alpha
+  auto const size = 2 * radius + 1;
+  auto const& corners = Raster::GetCornerMask( radius );
+  std::vector<rgba32> pixels( size * size, White );
+  for( auto y = 0; y < radius; ++y )
+  {
+    for( auto x = 0; x < radius; ++x )
+    {
+      auto const coverage = corners.left.at( y * radius + x );
+      pixels.at( y * size + x ).a = coverage;
+      pixels.at( y * size + ( size - 1 - x ) ).a = coverage;
+      pixels.at( ( size - 1 - y ) * size + x ).a = coverage;
+      pixels.at( ( size - 1 - y ) * size + ( size - 1 - x ) ).a = coverage;
+    }
+  }
+
+  auto texture = SDL_CreateTexture( m_Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size );
+  if( !texture )
+  {
+    throw std::runtime_error{ std::format( "Error creating rounded box texture: {}", SDL_GetError() ) };
+  }
+  SDL_UpdateTexture( texture, nullptr, pixels.data(), size * sizeof( rgba32 ) );
+  SDL_SetTextureBlendMode( texture, SDL_BLENDMODE_BLEND );
+
+  // slices map texels 1:1, except the middle one, which must not blur into the corners
+  SDL_SetTextureScaleMode( texture, SDL_ScaleModeNearest );
+
+  m_BoxTextures.emplace( radius, texture );
+  return texture;
+}
+
+void SdlBackend::flushBatch()
+{
+  // early exit: nothing pending
+  if( m_BatchIndices.empty() )
+  {
+    return;
+  }
+
+  SDL_RenderGeometry( m_Renderer, m_BatchTexture,
+    m_BatchVertices.data(), static_cast<int>( m_BatchVertices.size() ),
+    m_BatchIndices.data(), static_cast<int>( m_BatchIndices.size() ) );
+  Counters::Increment( Counters::GeometryBatches );
+
+  m_BatchVertices.clear();
+  m_BatchIndices.clear();
+}
@@ -0,0 +1,125 @@
+// SlotMap.hpp
+// values in one contiguous array, reached through stable handles
+//
+// Insert() and Erase() are O(1): erasing moves the last value into the hole, and the
+// handle's slot remembers where each value went. A slot's generation changes when its
+// value is erased, so an old handle to a reused slot finds nothing.
+
+#ifndef CORE_SLOT_MAP_HPP_INCLUDED
+#define CORE_SLOT_MAP_HPP_INCLUDED
+
+#include<cstddef>
+#include<cstdint>
+#include<limits>
+#include<utility>
+#include<vector>
+
+struct SlotHandle
+{
+  uint32_t index = std::numeric_limits<uint32_t>::max();
+  uint32_t generation = 0;
+
+  bool operator==( SlotHandle const& ) const = default;
+};
+
+template<typename T>
+class SlotMap
+{
+private:
+  static constexpr uint32_t s_None = std::numeric_limits<uint32_t>::max();
+
+  struct Slot
+  {
+    uint32_t dense;         // the value's index, or the next free slot
+    uint32_t generation = 0;
+  };
+
+  std::vector<T>        m_Values;
+  std::vector<uint32_t> m_ValueSlots;   // each value's slot
+  std::vector<Slot>     m_Slots;
+  uint32_t              m_FreeSlot = s_None;
+
+public:
+  SlotHandle Insert( T value )
+  {
+    auto index = m_FreeSlot;
+    if( index == s_None )
+    {
+      index = static_cast<uint32_t>( m_Slots.size() );
+      m_Slots.push_back( Slot{ .dense = s_None } );
+    }
+    else
+    {
+      m_FreeSlot = m_Slots.at( index ).dense;
+    }
+
+    auto& slot = m_Slots.at( index );
+    slot.dense = static_cast<uint32_t>( m_Values.size() );
+    m_Values.push_back( std::move( value ) );
+    m_ValueSlots.push_back( index );
+    return SlotHandle{ .index = index, .generation = slot.generation };
+  }
+
+  // false if 'handle' was already erased
+  bool Erase( SlotHandle handle )
+  {
+    // early exit: stale handle
+    if( !Contains( handle ) )
+    {
+      return false;
+    }
+
+    // move the last value into the hole
+    auto& slot = m_Slots.at( handle.index );
+    auto const dense = slot.dense;
+    if( dense + 1 != m_Values.size() )
+    {
+      m_Values.at( dense ) = std::move( m_Values.back() );
+      m_ValueSlots.at( dense ) = m_ValueSlots.back();
+      m_Slots.at( m_ValueSlots.at( dense ) ).dense = dense;
+    }
+    m_Values.pop_back();
+    m_ValueSlots.pop_back();
+
+    ++slot.generation;
+    slot.dense = m_FreeSlot;
+    m_FreeSlot = handle.index;
+    return true;
+  }
+
+  bool Contains( SlotHandle handle ) const
+  {
+    return handle.index < m_Slots.size() && m_Slots[ handle.index ].generation == handle.generation;
+  }
+
+  // nullptr if 'handle' was erased
+  T* Get( SlotHandle handle )
+  {
+    return Contains( handle ) ? &m_Values[ m_Slots[ handle.index ].dense ] : nullptr;
+  }
+
+  // the handle of the i'th value, for iterating by index
+  SlotHandle HandleAt( size_t i ) const
+  {
+    auto const index = m_ValueSlots.at( i );
+    return SlotHandle{ .index = index, .generation = m_Slots.at( index ).generation };
+  }
+
+  size_t Size() const
+  {
+    return m_Values.size();
+  }
+
+  bool Empty() const
+  {
+    return m_Values.empty();
+  }
+
+  // values in no particular order
+  auto begin() { return m_Values.begin(); }
+  auto end() { return m_Values.end(); }
+  auto begin() const { return m_Values.begin(); }
+  auto end() const { return m_Values.end(); }
+};
+
+#endif
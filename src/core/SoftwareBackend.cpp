@@ -0,0 +1,206 @@
+// SoftwareBackend.cpp
+
+#include "RenderBackend.hpp"
+#include "Raster.hpp"
+#include "Render.hpp"
+
+#include<algorithm>
+#include<format>
+#include<fstream>
+#include<stdexcept>
+
+SoftwareBackend::SoftwareBackend( int width, int height )
+  : m_Width{ std::max( width, 0 ) },
+    m_Height{ std::max( height, 0 ) },
+    m_Pixels( static_cast<size_t>( m_Width ) * m_Height ),
+    m_Clip{ .x = 0, .y = 0, .w = m_Width, .h = m_Height }
+{ }
+
+void SoftwareBackend::ClearScreen()
+{
+  std::fill( m_Pixels.begin(), m_Pixels.end(), rgba32{ 0, 0, 0, 255 } );
+}
+
+void SoftwareBackend::Present()
+{
+  // nothing to show: the frame stays in m_Pixels until the next ClearScreen()
+}
+
+void SoftwareBackend::DrawRect( Rect r, rgba32 colour )
+{
+  // early exit: nothing to draw
+  if( r.w <= 0 || r.h <= 0 )
+  {
+    return;
+  }
+
+  blendSpan( r.y, r.x, r.x + r.w, colour );
+  for( auto y = r.y + 1; y < r.y + r.h - 1; ++y )
+  {
+    blendSpan( y, r.x, r.x + 1, colour );
+    blendSpan( y, r.x + r.w - 1, r.x + r.w, colour );
+  }
+  if( r.h > 1 )
+  {
+    blendSpan( r.y + r.h - 1, r.x, r.x + r.w, colour );
+  }
+}
+
+void SoftwareBackend::DrawFilledRect( Rect r, rgba32 colour )
+{
+  for( auto y = r.y; y < r.y + r.h; ++y )
+  {
+    blendSpan( y, r.x, r.x + r.w, colour );
+  }
+}
+
+void SoftwareBackend::DrawRoundedBox( Rect r, int radius, rgba32 colour )
+{
+  radius = std::clamp( radius, 0, std::min( r.w, r.h ) / 2 );
+  auto const& corners = Raster::GetCornerMask( radius );
+  for( auto row = 0; row < r.h; ++row )
+  {
+    auto const y = r.y + row;
+
+    // straight edges: one span
+    auto const cornerRow = std::min( row, r.h - 1 - row );
+    if( cornerRow >= radius )
+    {
+      blendSpan( y, r.x, r.x + r.w, colour );
+      continue;
+    }
+
+    // anti-aliased corners either side of a span
+    auto const maskRow = cornerRow * radius;
+    blendMaskSpan( y, r.x, corners.left.data() + maskRow, radius, colour );
+    blendSpan( y, r.x + radius, r.x + r.w - radius, colour );
+    blendMaskSpan( y, r.x + r.w - radius, corners.right.data() + maskRow, radius, colour );
+  }
+}
+
+void SoftwareBackend::DrawText( Rect r, std::string const& s )
+{
+  auto const lineHeight = Render::MeasureTextLines( r.w, s, m_LineWidths );
+
+  // one bar per line, through the middle half of the line, clipped to 'r'
+  auto const numLines = static_cast<int>( m_LineWidths.size() );
+  for( auto i = 0; i < numLines; ++i )
+  {
+    auto const top = r.y + i * lineHeight;
+    auto const width = std::min<int>( m_LineWidths.at( i ), r.w );
+    for( auto y = top + lineHeight / 4; y < top + lineHeight * 3 / 4 && y < r.y + r.h; ++y )
+    {
+      blendSpan( y, r.x, r.x + width, White );
+    }
+  }
+}
+
+void SoftwareBackend::DrawMask( int x, int y, int w, int h, uint8_t const* mask, int stride, rgba32 tint )
+{
+  for( auto row = 0; row < h; ++row )
+  {
+    blendMaskSpan( y + row, x, mask + row * stride, w, tint );
+  }
+}
+
+void SoftwareBackend::SetClipRect( Rect clip )
+{
+  auto const x0 = std::clamp( clip.x, 0, m_Width );
+  auto const y0 = std::clamp( clip.y, 0, m_Height );
+  auto const x1 = std::clamp( clip.x + clip.w, x0, m_Width );
+  auto const y1 = std::clamp( clip.y + clip.h, y0, m_Height );
+  m_Clip = Rect{ .x = x0, .y = y0, .w = x1 - x0, .h = y1 - y0 };
+}
+
+void SoftwareBackend::ResetClipRect()
+{
+  m_Clip = Rect{ .x = 0, .y = 0, .w = m_Width, .h = m_Height };
+}
+
+int SoftwareBackend::Width() const
+{
+  return m_Width;
+}
+
+int SoftwareBackend::Height() const
+{
+  return m_Height;
+}
+
+rgba32 SoftwareBackend::GetPixel( int x, int y ) const
+{
+  return m_Pixels.at( static_cast<size_t>( y ) * m_Width + x );
+}
+
+std::vector<rgba32> const& SoftwareBackend::Pixels() const
+{
+  return m_Pixels;
+}
+
+void SoftwareBackend::SavePpm( std::string const& path ) const
+{
+  std::ofstream file{ path, std::ios::binary };
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Could not open '{}' for writing", path ) };
+  }
+
+  file << std::format( "P6\n{} {}\n255\n", m_Width, m_Height );
+  for( auto const pixel : m_Pixels )
+  {
+    char const rgb[] = { static_cast<char>( pixel.r ), static_cast<char>( pixel.g ), static_cast<char>( pixel.b ) };
+    file.write( rgb, sizeof( rgb ) );
+  }
+
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Failed writing '{}'", path ) };
+  }
+}
+
+void SoftwareBackend::blendSpan( int y, int x0, int x1, rgba32 colour )
+{
+  // early exit: row clipped
+  if( y < m_Clip.y || y >= m_Clip.y + m_Clip.h )
+  {
+    return;
+  }
+
+  x0 = std::max( x0, m_Clip.x );
+  x1 = std::min( x1, m_Clip.x + m_Clip.w );
+
+  // early exit: span clipped
+  if( x0 >= x1 )
+  {
+    return;
+  }
+
+  auto row = m_Pixels.data() + static_cast<size_t>( y ) * m_Width;
+  if( colour.a == 255 )
+  {
+    Raster::FillSpan( row + x0, x1 - x0, colour );
+    return;
+  }
+  Raster::BlendSpan( row + x0, x1 - x0, colour );
+}
+
+void SoftwareBackend::blendMaskSpan( int y, int x, uint8_t const* mask, int count, rgba32 colour )
+{
+  // early exit: row clipped
+  if( y < m_Clip.y || y >= m_Clip.y + m_Clip.h )
+  {
+    return;
+  }
+
+  auto const x0 = std::max( x, m_Clip.x );
+  auto const x1 = std::min( x + count, m_Clip.x + m_Clip.w );
+
+  // early exit: span clipped
+  if( x0 >= x1 )
+  {
+    return;
+  }
+
+  auto row = m_Pixels.data() + static_cast<size_t>( y ) * m_Width;
+  Raster::BlendMaskSpan( row + x0, mask + ( x0 - x ), x1 - x0, colour );
+}
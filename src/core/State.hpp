@@ -13,6 +13,8 @@ struct WidgetState
 	bool isHovered = false;
 	bool isVisible = true;
   bool isInHitTree = false;
+
+  bool operator==( WidgetState const& ) const = default;
 };
 
 // when a widget has a different origin to its parent
@@ -23,24 +25,54 @@ struct Transform
   // parent's origin relative to mine
   int x = 0;
   int y = 0;
+
+  bool operator==( Transform const& ) const = default;
 };
 
+// children are stacked top to bottom, so the visible ones are a run of them:
+// [first, last) of GetChildWidgets(), as of the latest layout
 struct VisibleChildren
 {
   static constexpr auto AsString = "VisibleChildren";
   
-  std::vector<Key> children;
+  size_t first = 0;
+  size_t last = 0;
+
+  bool operator==( VisibleChildren const& ) const = default;
+};
+
+// what a Text widget says: set it with SetText()
+struct TextContent
+{
+	static constexpr auto AsString = "TextContent";
+	std::string text;
+
+	bool operator==( TextContent const& ) const = default;
 };
 
 struct TextState
 {
 	static constexpr auto AsString = "TextState";
 	int width;
+	int height = -1;  // measured once width is known, see TextLayout
+
+	bool operator==( TextState const& ) const = default;
 };
 
 struct OnBuildLayout
 {
   static constexpr auto AsString = "OnBuildLayout";
+
+  bool operator==( OnBuildLayout const& ) const = default;
+};
+
+// whether a widget lays out its children, e.g. computed by Hiding
+struct Visibility
+{
+  static constexpr auto AsString = "Visibility";
+  bool isVisible = true;
+
+  bool operator==( Visibility const& ) const = default;
 };
 
 #endif
\ No newline at end of file
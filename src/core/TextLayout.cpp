@@ -0,0 +1,88 @@
+// TextLayout.cpp
+
+#include "TextLayout.hpp"
+#include "Counters.hpp"
+#include "Profiler.hpp"
+#include "Render.hpp"
+#include "ThreadPool.hpp"
+
+#include<SDL_FontCache/SDL_FontCache.h>
+
+#include<unordered_map>
+#include<vector>
+
+namespace TextLayout
+{
+  struct Request
+  {
+    int width;
+    std::string const* text;
+    int* height;
+    bool missingGlyphs = false;
+  };
+
+  // UI thread only, except during MeasureQueued()
+  static std::vector<Request> s_Queue;
+  static std::unordered_map<int*, size_t> s_QueueIndex;   // at most one request per destination
+
+  // requests per chunk of parallel work
+  static constexpr size_t s_MinChunk = 32;
+
+  void QueueHeight( int width, std::string const& text, int& height )
+  {
+    height = -1;
+    auto request = Request{ .width = width, .text = &text, .height = &height };
+
+    // re-queued (e.g. the width was overridden): the latest width wins
+    auto [ it, inserted ] = s_QueueIndex.try_emplace( &height, s_Queue.size() );
+    if( !inserted )
+    {
+      s_Queue.at( it->second ) = request;
+      return;
+    }
+    s_Queue.push_back( request );
+  }
+
+  void MeasureQueued()
+  {
+    // early exit: nothing queued
+    if( s_Queue.empty() )
+    {
+      return;
+    }
+    Counters::Increment( Counters::TextMeasurements, s_Queue.size() );
+
+    // nothing may cache glyphs while measuring, e.g. a render thread drawing text
+    auto renderer = Render::LockRenderer();
+
+    // measure in parallel: each request writes only its own destination
+    WorkerPool().ParallelFor( s_Queue.size(),
+      [] ( size_t begin, size_t end )
+      {
+        DRUI_PROFILE_SCOPE( "MeasureTextChunk" );
+        FC_MeasureContext ctx;
+        for( auto i = begin; i < end; ++i )
+        {
+          auto& request = s_Queue.at( i );
+          FC_InitMeasureContext( &ctx );
+          *request.height = Render::MeasureTextHeight( ctx, request.width, *request.text );
+          request.missingGlyphs = ctx.num_missing > 0;
+        }
+      },
+      s_MinChunk
+    );
+
+    // uncached glyphs were measured as spaces: cache them and measure again
+    for( auto const& request : s_Queue )
+    {
+      if( request.missingGlyphs )
+      {
+        *request.height = Render::CalcTextHeight( Render::Rect{ .w = request.width }, *request.text );
+      }
+    }
+
+    s_Queue.clear();
+    s_QueueIndex.clear();
+  }
+
+} // namespace TextLayout
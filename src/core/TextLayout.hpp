@@ -0,0 +1,26 @@
+// TextLayout.hpp
+// height-for-width text measurement during layout
+//
+// Text whose height depends on its width queues a measurement as soon as the
+// width pass of RebuildLayoutTree() has settled its width. The whole queue is
+// then measured in parallel, before the height pass reads the results.
+
+#ifndef CORE_TEXT_LAYOUT_HPP_INCLUDED
+#define CORE_TEXT_LAYOUT_HPP_INCLUDED
+
+#include<string>
+
+namespace TextLayout
+{
+  // sets 'height' to -1 now, and to the measured height in MeasureQueued().
+  // 'text' and 'height' must outlive the call to MeasureQueued().
+  void QueueHeight( int width, std::string const& text, int& height );
+
+  // measure everything queued, then clear the queue.
+  // Worker threads only read glyph metrics; any glyphs that still need
+  // rasterizing are cached, and their text re-measured, on the calling thread.
+  void MeasureQueued();
+
+} // namespace TextLayout
+
+#endif
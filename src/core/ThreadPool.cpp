@@ -0,0 +1,215 @@
+// ThreadPool.cpp
+
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
+
+#include<algorithm>
+#include<atomic>
+#include<exception>
+#include<memory>
+
+namespace
+{
+  // which pool's worker, if any, is this thread?
+  thread_local ThreadPool const* t_Pool = nullptr;
+  thread_local size_t t_Worker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool( unsigned numWorkers, size_t capacity )
+  : m_Capacity{ capacity }
+{
+  for( auto i = 0u; i < numWorkers; ++i )
+  {
+    m_Queues.push_back( std::make_unique<WorkQueue>() );
+  }
+  for( auto i = 0u; i < numWorkers; ++i )
+  {
+    m_Workers.emplace_back( [ this, i ] { workerLoop( i ); } );
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard lock{ m_Mutex };
+    m_Stopping = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  // join before the members the workers use are destroyed
+  m_Workers.clear();
+}
+
+unsigned ThreadPool::NumWorkers() const
+{
+  return static_cast<unsigned>( m_Workers.size() );
+}
+
+bool ThreadPool::TryPush( Task task )
+{
+  // early exit: backpressure
+  if( m_Workers.empty() || m_Queued.load() >= static_cast<std::ptrdiff_t>( m_Capacity ) )
+  {
+    return false;
+  }
+  push( std::move( task ) );
+  return true;
+}
+
+void ThreadPool::push( Task task )
+{
+  // a worker keeps its own tasks; others are dealt out
+  auto const worker = t_Pool == this ? t_Worker : m_NextQueue++ % m_Queues.size();
+  {
+    auto& queue = *m_Queues.at( worker );
+    std::lock_guard lock{ queue.mutex };
+    queue.tasks.push_back( std::move( task ) );
+  }
+  {
+    std::lock_guard lock{ m_Mutex };
+    ++m_Queued;
+  }
+  m_WorkAvailable.notify_one();
+}
+
+bool ThreadPool::tryPop( size_t worker, Task& task )
+{
+  // newest of our own, while it's still hot in cache
+  {
+    auto& queue = *m_Queues.at( worker );
+    std::lock_guard lock{ queue.mutex };
+    if( !queue.tasks.empty() )
+    {
+      task = std::move( queue.tasks.back() );
+      queue.tasks.pop_back();
+      --m_Queued;
+      return true;
+    }
+  }
+
+  // else steal the oldest of someone else's
+  for( size_t i = 1; i < m_Queues.size(); ++i )
+  {
+    auto& queue = *m_Queues.at( ( worker + i ) % m_Queues.size() );
+    std::lock_guard lock{ queue.mutex };
+    if( !queue.tasks.empty() )
+    {
+      task = std::move( queue.tasks.front() );
+      queue.tasks.pop_front();
+      --m_Queued;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::workerLoop( size_t worker )
+{
+  DRUI_PROFILE_THREAD( "worker" );
+  t_Pool = this;
+  t_Worker = worker;
+  while( true )
+  {
+    Task task;
+    if( tryPop( worker, task ) )
+    {
+      task();
+      continue;
+    }
+
+    // nothing to run or steal: wait for a push
+    std::unique_lock lock{ m_Mutex };
+    m_WorkAvailable.wait( lock, [ this ] { return m_Stopping || m_Queued > 0; } );
+    if( m_Stopping && m_Queued <= 0 )
+    {
+      return;
+    }
+  }
+}
+
+void ThreadPool::ParallelFor( size_t count, RangeMethod body, size_t minChunk )
+{
+  // early exit: nothing to do
+  if( count == 0 )
+  {
+    return;
+  }
+
+  // early exit: not worth splitting
+  minChunk = std::max<size_t>( minChunk, 1 );
+  if( m_Workers.empty() || count <= minChunk )
+  {
+    body( 0, count );
+    return;
+  }
+
+  // a few chunks per thread, to even out the load
+  auto const numThreads = m_Workers.size() + 1;
+  auto const maxChunks = std::min( ( count + minChunk - 1 ) / minChunk, numThreads * 4 );
+  auto const chunkSize = ( count + maxChunks - 1 ) / maxChunks;
+  auto const numChunks = ( count + chunkSize - 1 ) / chunkSize;
+
+  // shared with the helper tasks, which may outlive this call
+  // (by which time there are no chunks left for them to run, so
+  // none calls 'body' after it's gone)
+  struct Shared
+  {
+    RangeMethod body;
+    std::atomic<size_t> next = 0;
+    size_t done = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable finished;
+  };
+  auto shared = std::make_shared<Shared>( body );
+
+  auto runChunks = [ shared, count, chunkSize, numChunks ]
+  {
+    for( auto chunk = shared->next++; chunk < numChunks; chunk = shared->next++ )
+    {
+      auto begin = chunk * chunkSize;
+      auto end = std::min( begin + chunkSize, count );
+      try
+      {
+        shared->body( begin, end );
+      }
+      catch( ... )
+      {
+        std::lock_guard lock{ shared->mutex };
+        if( !shared->error )
+        {
+          shared->error = std::current_exception();
+        }
+      }
+
+      std::lock_guard lock{ shared->mutex };
+      if( ++shared->done == numChunks )
+      {
+        shared->finished.notify_one();
+      }
+    }
+  };
+
+  // enlist the workers, and help out
+  auto const numHelpers = std::min( m_Workers.size(), numChunks - 1 );
+  for( auto i = 0u; i < numHelpers; ++i )
+  {
+    push( runChunks );
+  }
+  runChunks();
+
+  // wait for the stragglers
+  std::unique_lock lock{ shared->mutex };
+  shared->finished.wait( lock, [ &shared, numChunks ] { return shared->done == numChunks; } );
+  if( shared->error )
+  {
+    std::rethrow_exception( shared->error );
+  }
+}
+
+ThreadPool& WorkerPool()
+{
+  static ThreadPool s_Pool{ std::max( 1u, std::thread::hardware_concurrency() ) - 1 };
+  return s_Pool;
+}
@@ -0,0 +1,72 @@
+// ThreadPool.hpp
+//
+// Each worker has its own deque: it runs its newest task first, and when that's empty
+// steals the oldest from another. Tasks pushed from a worker go on its own deque, others
+// are dealt round-robin.
+
+#ifndef CORE_THREAD_POOL_HPP_INCLUDED
+#define CORE_THREAD_POOL_HPP_INCLUDED
+
+#include<atomic>
+#include<condition_variable>
+#include<deque>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+#include "core/InplaceFunction.hpp"
+
+class ThreadPool
+{
+public:
+  using Task = InplaceFunction< void() >;
+  using RangeMethod = FunctionRef< void( size_t begin, size_t end ) >;
+
+private:
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> m_Queues;   // one per worker
+  std::vector<std::jthread> m_Workers;
+  size_t const m_Capacity;
+  std::atomic<size_t> m_NextQueue = 0;
+
+  // tasks in all queues; may dip below zero while a push is under way
+  std::atomic<std::ptrdiff_t> m_Queued = 0;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkAvailable;
+  bool m_Stopping = false;
+
+public:
+  // TryPush() refuses tasks once 'capacity' are waiting
+  explicit ThreadPool( unsigned numWorkers, size_t capacity = 1024 );
+  ~ThreadPool();
+
+  ThreadPool( ThreadPool const& ) = delete;
+  ThreadPool& operator=( ThreadPool const& ) = delete;
+
+  unsigned NumWorkers() const;
+
+  // split [0, count) into chunks of at least 'minChunk' and run 'body' over them
+  // on the workers and the calling thread. Returns once every chunk is done,
+  // rethrowing the first exception thrown by 'body'.
+  void ParallelFor( size_t count, RangeMethod body, size_t minChunk = 1 );
+
+  // queue 'task' for a worker, unless the pool is at capacity (or has no workers)
+  bool TryPush( Task task );
+
+private:
+  void push( Task task );
+  bool tryPop( size_t worker, Task& task );
+  void workerLoop( size_t worker );
+};
+
+// shared pool with one worker per additional hardware thread
+ThreadPool& WorkerPool();
+
+#endif
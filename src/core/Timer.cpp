@@ -0,0 +1,196 @@
+// Timer.cpp
+
+#include "Timer.hpp"
+
+#include<Console/Console.hpp>
+
+#include<algorithm>
+#include<cmath>
+#include<format>
+#include<fstream>
+#include<stdexcept>
+
+namespace
+{
+  double milliseconds( Timer::Clock::duration d )
+  {
+    return std::chrono::duration<double, std::milli>( d ).count();
+  }
+
+  // timed waits tend to overshoot; wake a little early
+  constexpr auto s_WakeEarly = std::chrono::microseconds( 100 );
+
+} // namespace
+
+
+////////////////////
+// FrameHistogram //
+////////////////////
+
+void FrameHistogram::Add( double ms )
+{
+  auto const bucket = static_cast<size_t>( std::max( ms, 0.0 ) / BucketMs );
+  ++m_Buckets.at( std::min( bucket, NumBuckets ) );
+  ++m_Count;
+  m_Sum += ms;
+  m_Max = std::max( m_Max, ms );
+}
+
+uint64_t FrameHistogram::Count() const
+{
+  return m_Count;
+}
+
+double FrameHistogram::Mean() const
+{
+  return m_Count ? m_Sum / m_Count : 0.0;
+}
+
+double FrameHistogram::Max() const
+{
+  return m_Max;
+}
+
+double FrameHistogram::Percentile( double p ) const
+{
+  // early exit: no samples
+  if( !m_Count )
+  {
+    return 0.0;
+  }
+
+  // nearest rank
+  auto const rank = std::clamp<uint64_t>( static_cast<uint64_t>( std::ceil( p / 100.0 * m_Count ) ), 1, m_Count );
+  uint64_t seen = 0;
+  for( size_t bucket = 0; bucket < NumBuckets; ++bucket )
+  {
+    seen += m_Buckets.at( bucket );
+    if( seen >= rank )
+    {
+      return std::min( ( bucket + 1 ) * BucketMs, m_Max );
+    }
+  }
+  return m_Max;
+}
+
+uint64_t FrameHistogram::BucketCount( size_t bucket ) const
+{
+  return m_Buckets.at( bucket );
+}
+
+
+///////////
+// Timer //
+///////////
+
+Timer::Timer( Pacing pacing, int fps )
+  : m_Pacing{ pacing },
+    m_Period{ std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1.0 / std::max( fps, 1 ) ) ) },
+    m_FrameStart{ Clock::now() },
+    m_Deadline{ m_FrameStart + m_Period }
+{ }
+
+void Timer::Sleep()
+{
+  auto const workEnd = Clock::now();
+  m_WorkTimes.Add( milliseconds( workEnd - m_FrameStart ) );
+
+  if( m_Pacing == Pacing::Fixed )
+  {
+    if( workEnd > m_Deadline )
+    {
+      // missed: skip the deadlines we overran and restart the phase from now
+      m_MissedFrames += 1 + ( workEnd - m_Deadline ) / m_Period;
+      m_Deadline = workEnd;
+    }
+    else
+    {
+      std::unique_lock lock{ m_WakeMutex };
+      if( m_WakeUp.wait_until( lock, m_Deadline - s_WakeEarly, [ this ] () { return m_Woken; } ) )
+      {
+        m_Deadline = Clock::now();
+      }
+    }
+  }
+  {
+    std::scoped_lock lock{ m_WakeMutex };
+    m_Woken = false;
+  }
+
+  auto const frameStart = Clock::now();
+  auto const interval = frameStart - m_FrameStart;
+  m_FrameTimes.Add( milliseconds( interval ) );
+
+  // vsync: Present() did the waiting, so a long interval means missed refreshes
+  if( m_Pacing == Pacing::VSync && interval > m_Period * 3 / 2 )
+  {
+    m_MissedFrames += static_cast<uint64_t>( std::llround( static_cast<double>( interval.count() ) / m_Period.count() ) ) - 1;
+  }
+
+  m_FrameStart = frameStart;
+  m_Deadline += m_Period;
+}
+
+void Timer::Wake()
+{
+  {
+    std::scoped_lock lock{ m_WakeMutex };
+    m_Woken = true;
+  }
+  m_WakeUp.notify_one();
+}
+
+Pacing Timer::GetPacing() const
+{
+  return m_Pacing;
+}
+
+uint64_t Timer::MissedFrames() const
+{
+  return m_MissedFrames;
+}
+
+FrameHistogram const& Timer::WorkTimes() const
+{
+  return m_WorkTimes;
+}
+
+FrameHistogram const& Timer::FrameTimes() const
+{
+  return m_FrameTimes;
+}
+
+void Timer::PrintStats() const
+{
+  static constexpr std::array<std::string_view, 3> s_PacingNames = { "fixed", "vsync", "unlocked" };
+
+  Console::PrintLn( "{} frames, {} pacing at {:.1f} ms, {} missed",
+    m_FrameTimes.Count(), s_PacingNames.at( static_cast<size_t>( m_Pacing ) ), milliseconds( m_Period ), m_MissedFrames );
+  Console::PrintLn( "{:>6} {:>10} {:>10} {:>10} {:>10} {:>10}", "", "mean ms", "p50", "p99", "p999", "max" );
+  for( auto [ name, histogram ] : { std::pair{ "work", &m_WorkTimes }, std::pair{ "frame", &m_FrameTimes } } )
+  {
+    Console::PrintLn( "{:>6} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}",
+      name, histogram->Mean(), histogram->Percentile( 50.0 ), histogram->Percentile( 99.0 ), histogram->Percentile( 99.9 ), histogram->Max() );
+  }
+}
+
+void Timer::WriteStats( std::string const& path ) const
+{
+  std::ofstream file{ path };
+  if( !file )
+  {
+    throw std::runtime_error{ std::format( "Could not write frame stats to '{}'", path ) };
+  }
+
+  file << "ms,work,frame\n";
+  for( size_t bucket = 0; bucket <= FrameHistogram::NumBuckets; ++bucket )
+  {
+    auto const work = m_WorkTimes.BucketCount( bucket );
+    auto const frame = m_FrameTimes.BucketCount( bucket );
+    if( work || frame )
+    {
+      // the last bucket is everything from 100 ms up
+      file << std::format( "{:.2f},{},{}\n", bucket * FrameHistogram::BucketMs, work, frame );
+    }
+  }
+}
@@ -1,34 +1,97 @@
 // Timer.hpp
-
+//
+// frame pacing for the interactive main loop, plus frame-time telemetry
+//
+// fixed pacing originally after
 // https://stackoverflow.com/questions/77744136/achieving-stable-60fps-with-sdl2
 
 #ifndef TIMER_HPP_INCLUDED
 #define TIMER_HPP_INCLUDED
 
+#include <array>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
-#include <iostream>
-#include <thread>
-#include <type_traits>
+#include <mutex>
+#include <string>
+
+enum class Pacing
+{
+  Fixed,    // sleep until the next frame's deadline
+  VSync,    // Present() blocks on the display; just measure
+  Unlocked  // run flat out, for benchmarking
+};
+
+// frame times in 50 us buckets up to 100 ms, then an overflow bucket
+class FrameHistogram
+{
+public:
+  static constexpr double BucketMs   = 0.05;
+  static constexpr size_t NumBuckets = 2000;
+
+private:
+  std::array<uint64_t, NumBuckets + 1> m_Buckets{};
+  uint64_t m_Count = 0;
+  double   m_Sum   = 0.0;
+  double   m_Max   = 0.0;
+
+public:
+  void Add( double ms );
+
+  uint64_t Count() const;
+  double Mean() const;
+  double Max() const;
+
+  // p in [0, 100]; the upper edge of the bucket holding that rank
+  double Percentile( double p ) const;
+
+  uint64_t BucketCount( size_t bucket ) const;
+};
 
-template<std::intmax_t FPS>
 class Timer
 {
 public:
-  static constexpr std::chrono::duration<double, std::ratio<1, FPS>> time_between_frames{ 1 };
+  using Clock = std::chrono::steady_clock;
 
 private:
-  std::chrono::time_point<std::chrono::steady_clock, std::remove_const_t<decltype( time_between_frames )>> tp;
+  Pacing            m_Pacing;
+  Clock::duration   m_Period;
+  Clock::time_point m_FrameStart;
+  Clock::time_point m_Deadline;
+  uint64_t          m_MissedFrames = 0;
+  FrameHistogram    m_WorkTimes;
+  FrameHistogram    m_FrameTimes;
+
+  std::mutex              m_WakeMutex;
+  std::condition_variable m_WakeUp;
+  bool                    m_Woken = false;
 
 public:
-  Timer() : tp{ std::chrono::steady_clock::now() } {}
-
-  void Sleep()
-  {
-      tp += time_between_frames;
-      std::this_thread::sleep_until(tp - std::chrono::microseconds(100));
-      // while(std::chrono::steady_clock::now() < tp) {}
-  }
+  // 'fps' is the target rate for Fixed, and the display's refresh rate for VSync
+  explicit Timer( Pacing pacing = Pacing::Fixed, int fps = 60 );
+
+  // call once a frame's work is done: records how long it took, then waits
+  // for the next frame. a late frame counts the deadlines it overran and
+  // starts the next frame straight away, on a new phase, rather than
+  // bursting frames to catch up
+  void Sleep();
+
+  // any thread: cut the current (or next) Sleep() short, so the next frame
+  // starts now on a new phase
+  void Wake();
+
+  Pacing GetPacing() const;
+  uint64_t MissedFrames() const;
+
+  // time spent working, and start-to-start frame intervals
+  FrameHistogram const& WorkTimes() const;
+  FrameHistogram const& FrameTimes() const;
+
+  // p50/p99/p999 of both histograms, to the console
+  void PrintStats() const;
+
+  // both histograms as csv, one row per non-empty bucket
+  void WriteStats( std::string const& path ) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,18 +3,22 @@
 #ifndef WIDGET_HPP_INCLUDED
 #define WIDGET_HPP_INCLUDED
 
-#include<functional>
+#include<cstdint>
 #include<string>
 #include<tuple>
 
 #include<Layout/Layouts.hpp>
 
+#include "InplaceFunction.hpp"
 #include "Key.hpp"
 
-using InitStateMethod    = std::function< void( Key ) >;
-using BuildLayoutMethod  = std::function< Layouts::LayoutBuilder( Key ) >;
-using RenderWidgetMethod = std::function< bool( Key, Layouts::Rect ) >;
-using HitTestMethod      = std::function< bool( Layouts::LayoutBuilder const&, int, int, std::vector<Key>& ) >;
+// made once per widget, so room to capture a string and a format
+constexpr size_t WidgetMethodCapacity = 64;
+
+using InitStateMethod    = InplaceFunction< void( Key ), WidgetMethodCapacity >;
+using BuildLayoutMethod  = InplaceFunction< Layouts::LayoutBuilder( Key ), WidgetMethodCapacity >;
+using RenderWidgetMethod = InplaceFunction< bool( Key, Layouts::Rect ), WidgetMethodCapacity >;
+using HitTestMethod      = InplaceFunction< bool( Layouts::LayoutBuilder const&, int, int, std::vector<Key>& ), WidgetMethodCapacity >;
 
 struct Widget
 {
@@ -22,11 +26,18 @@ struct Widget
 	Key self;
 	Key parent;
 	InitStateMethod initState;
+	InitStateMethod extraInitState;   // Custom's, run after initState
 	BuildLayoutMethod buildLayout;
 	HitTestMethod runHitTest;
 	RenderWidgetMethod renderWidget;
 	std::vector<Key> children;
+	std::string childKey;     // tells it from its siblings, if SetChildren() made it
+	std::string signature;    // the kind of subtree it roots, if SetChildren() may recycle it
 	Layouts::LayoutBuilder layout;
+	bool isCullable = true;   // skipped when its rect isn't visible
+	bool isInitialised = false;
+	bool isPooled = false;    // recycled, and not yet reused: as good as destroyed
+	uint32_t incarnation = 1; // bumped when recycled, so what was queued for it is dropped
 };
 
 
@@ -1,20 +1,97 @@
 // main.cpp
+//
+// usage: app [--record <trace file>] [--render-thread] [--hud]
+//            [--pacing fixed | vsync | unlocked] [--fps <n>] [--frame-stats <csv file>]
 
 #include "core/Application.hpp"
 #include "core/App.hpp"
 
+#include<charconv>
+#include<format>
 #include<iostream>
+#include<stdexcept>
+#include<string>
+#include<string_view>
 
-int main()
+int main( int argc, char* argv[] )
 {
 	try
 	{
+		RunOptions options;
+		bool renderThread = false;
+		bool hud = false;
+		for( auto i = 1; i < argc; ++i )
+		{
+			auto const arg = std::string_view{ argv[ i ] };
+
+			// record input for replay by 'bench frames'?
+			if( arg == "--record" && i + 1 < argc )
+			{
+				options.recordPath = argv[ ++i ];
+			}
+
+			// how to pace frames?
+			else if( arg == "--pacing" && i + 1 < argc )
+			{
+				auto const pacing = std::string_view{ argv[ ++i ] };
+				if( pacing == "fixed" )
+				{
+					options.pacing = Pacing::Fixed;
+				}
+				else if( pacing == "vsync" )
+				{
+					options.pacing = Pacing::VSync;
+				}
+				else if( pacing == "unlocked" )
+				{
+					options.pacing = Pacing::Unlocked;
+				}
+				else
+				{
+					throw std::runtime_error{ std::format( "Unknown pacing '{}'", pacing ) };
+				}
+			}
+
+			// target frame rate?
+			else if( arg == "--fps" && i + 1 < argc )
+			{
+				auto const fps = std::string_view{ argv[ ++i ] };
+				std::from_chars( fps.data(), fps.data() + fps.size(), options.fps );
+			}
+
+			// save frame-time histograms?
+			else if( arg == "--frame-stats" && i + 1 < argc )
+			{
+				options.statsPath = argv[ ++i ];
+			}
+
+			// present from a render thread?
+			else if( arg == "--render-thread" )
+			{
+				renderThread = true;
+			}
+
+			// show engine counters?
+			else if( arg == "--hud" )
+			{
+				hud = true;
+			}
+		}
+
 		Application app{ AppWidth(), AppHeight(), App() };
-		app.Run(); 
+		if( renderThread )
+		{
+			app.UseRenderThread();
+		}
+		if( hud )
+		{
+			app.ShowPerfHud();
+		}
+		app.Run( options );
 		return 0;
 	}
 	catch( std::exception const& e )
 	{
 		std::cerr << "\nException caught: " << e.what() << '\n';
 	}
-}
\ No newline at end of file
+}
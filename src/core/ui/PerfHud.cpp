@@ -0,0 +1,56 @@
+// PerfHud.cpp
+
+#include "core/ui/Widgets.hpp"
+#include "core/Counters.hpp"
+
+#include<algorithm>
+#include<format>
+#include<iterator>
+#include<string>
+
+using namespace Layouts;
+
+// the HUD's text, from the latest figures
+static std::string perfHudText()
+{
+	std::string text;
+	auto out = std::back_inserter( text );
+
+	std::format_to( out, "frame ms (last {}): avg {:.2f}  p50 {:.2f}  p95 {:.2f}  p99 {:.2f}\n",
+		Counters::NumFrames(),
+		Counters::AverageFrameMs(),
+		Counters::FrameMsPercentile( 50.0 ),
+		Counters::FrameMsPercentile( 95.0 ),
+		Counters::FrameMsPercentile( 99.0 ) );
+
+	for( auto i = 0; i < Counters::NumCounters; ++i )
+	{
+		auto const counter = static_cast<Counters::Counter>( i );
+		std::format_to( out, "{}: {:.1f}\n", Counters::Name( counter ), Counters::Average( counter ) );
+	}
+
+	auto const atlas = Render::GetGlyphAtlasCounters();
+	std::format_to( out, "glyph atlas: {} KiB, {} pages, {} evictions",
+		atlas.bytes / 1024, atlas.pages, atlas.evictions );
+
+	return text;
+}
+
+Key PerfHud( int width, int height, RoundedBoxFormat format )
+{
+	// the HUD has a fixed size, and so does its text, so new figures never force a relayout
+	auto const inset = format.radius;
+	auto const text = Text( AutoWidth, HeightExactly( std::max( height - 2 * inset, 0 ) ), "", Font{} );
+
+	return RoundedBox( WidthExactly( width ), HeightExactly( height ), format, RefuseHitTest,
+		Padding( AutoWidth, AutoHeight, inset, inset, inset, inset, text )
+	);
+}
+
+void UpdatePerfHud( Key hud )
+{
+	// RoundedBox > Padding > Text
+	auto const padding = GetChildWidgets( hud ).front();
+	auto const text = GetChildWidgets( padding ).front();
+	SetText( text, perfHudText() );
+}
@@ -0,0 +1,55 @@
+// RepaintBoundary.cpp
+
+#include "core/ui/Widgets.hpp"
+
+Key RepaintBoundary( Key child )
+{
+	return CreateWidget( "",
+
+		// initState
+		[] ( Key self )
+		{
+			CreateState<WidgetState>( self );
+		},
+
+		// buildLayout
+		[] ( Key self )
+		{
+			return Box( AutoWidth, AutoHeight );
+		},
+
+		// renderWidget
+		[] ( Key self, Rect r ) -> bool
+		{
+			// early exit: unchanged since last drawn
+			if( Render::DrawLayer( self, r ) )
+			{
+				return false;
+			}
+
+			// early exit: can't cache, so draw children directly
+			if( !Render::BeginLayer( self, r ) )
+			{
+				return true;
+			}
+
+			// render children myself, into the layer,
+			// with the same adjustment as mine
+			auto layout = GetWidgetRect( self );
+			for( auto const child : GetChildWidgets( self ) )
+			{
+				RenderLayoutTree( child, r.x - layout.x, r.y - layout.y );
+			}
+			Render::EndLayer( self, r );
+			return false;
+		},
+
+		// hitTest
+		DefaultHitTest,
+
+		// children
+		{
+			child
+		}
+	);
+}
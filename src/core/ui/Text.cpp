@@ -1,7 +1,9 @@
 // Text.cpp
 
 #include "core/Database.hpp"
+#include "core/Counters.hpp"
 #include "core/Render.hpp"
+#include "core/TextLayout.hpp"
 
 using namespace Layouts;
 
@@ -10,9 +12,10 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 	return CreateWidget( "",
 
 		// initState
-		[ height ] ( Key self )
+		[ height, text ] ( Key self )
 		{
 			CreateState<WidgetState>( self );
+			CreateState<TextContent>( self, TextContent{ .text = text } );
 
 			// does the height need to be calculated from the width?
 			if( height.requestType == Intervals::RequestType::AtLeast )
@@ -23,14 +26,18 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 		},
 
 		// buildLayout
-		[ width, height, &text ] ( Key self )
+		[ width, height ] ( Key self )
 		{
+			// NB: states don't move, so the layout may refer to it
+			auto const& text = GetState<TextContent>( self ).text;
+
 			// does the height need to be calculated from the width?
 			if( height.requestType == Intervals::RequestType::AtLeast )
 			{
 				// yes, so create a custom Layout that enables width-height communication
 				// during Layout dimensioning
 				auto& actualWidth = const_cast<int&>( GetState<TextState>( self ).width );
+				auto& actualHeight = const_cast<int&>( GetState<TextState>( self ).height );
 				return LayoutBuilder
 				{
 					Intervals::IntervalBuilder
@@ -42,6 +49,9 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 							{
 								actualWidth = width;
 								// Console::Print( "\nWidget {} setting TextState::width to {}.", self, actualWidth );
+
+								// measure once the width pass is done, along with all other text
+								TextLayout::QueueHeight( actualWidth, text, actualHeight );
 							}
 						}
 					},
@@ -52,6 +62,13 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 							.extentRequest = height,
 							.deduceExtent = [ &, self ] ( Intervals::IntervalBuilder const& )
 							{
+								// early exit: already measured
+								if( actualHeight >= 0 )
+								{
+									return actualHeight;
+								}
+
+								Counters::Increment( Counters::TextMeasurements );
 								auto h = Render::CalcTextHeight( Rect{ .w = actualWidth }, text );
 								// Console::Print( "\nWidget {} with text '{}' returning a calculated height of {}.", self, text, h );
 								return h;
@@ -66,11 +83,11 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 		},
 
 		// renderWidget
-		[ text, font ] ( Key self, Rect r ) -> bool
+		[ font ] ( Key self, Rect r ) -> bool
 		{
 			// Console::Print( "\nWidget {} has render height {}.", self, r.h );
 			// Render::DrawRect( r, White );
-			Render::DrawText( r, text );
+			Render::DrawText( r, GetState<TextContent>( self ).text );
 			return true;
 		},
 
@@ -80,4 +97,26 @@ Key Text( WidthRequest width, HeightRequest height, std::string const& text, Fon
 		// children
 		{}
 	);
+}
+
+void SetText( Key textWidget, std::string text )
+{
+	// early exit: saying that already
+	if( GetState<TextContent>( textWidget ).text == text )
+	{
+		return;
+	}
+
+	SetState<TextContent>( textWidget,
+		[ text = std::move( text ) ] ( TextContent& content )
+		{
+			content.text = text;
+		}
+	);
+
+	// its height may change, if measured
+	if( HasState<TextState>( textWidget ) )
+	{
+		SetRebuildLayoutTree();
+	}
 }
\ No newline at end of file
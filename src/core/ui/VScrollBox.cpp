@@ -3,47 +3,75 @@
 #include "core/Database.hpp"
 #include "core/Render.hpp"
 
+#include<algorithm>
+#include<span>
+
 
 using namespace Layouts;
 
-static void calcVisibleChildren( Key self, Transform const& transform )
+// computed from Transform, and the layout (signalled by OnBuildLayout).
+// A range rather than a list, so scrolling allocates nothing
+static VisibleChildren calcVisibleChildren( Key self )
 {
-	// calculate visible children whenever transform changes
-	// NB: this is the slow way, recomputing the whole array
-	// on each update
-	auto parentRect = GetWidgetRect( self );
-	std::vector<Key> visibleChildren;
-	for( auto const child : GetChildWidgets( self ) )
-	{
-		// init calculations
-		auto childRect  = GetWidgetRect( child );
-		auto childHead  = childRect.y;
-		auto childFoot  = childHead + childRect.h;
-		auto parentHead = transform.y;
-		auto parentFoot = parentHead + parentRect.h;
-
-		// this is how I can make sense of it right now, ok?
-		bool childFoot_above_parentHead = childFoot < parentHead;
-		bool childHead_below_parentFoot = childHead > parentFoot;
-		if( childFoot_above_parentHead )
+	auto const& transform = GetState<Transform>( self );
+	GetState<OnBuildLayout>( self );  // read only to depend on it
+	auto const parentRect = GetWidgetRect( self );
+	auto const parentHead = transform.y;
+	auto const parentFoot = parentHead + parentRect.h;
+
+	// children are stacked top to bottom: skip those whose foot is above my head,
+	// up to the first whose head is below my foot
+	auto const& children = GetChildWidgets( self );
+	auto const first = std::partition_point( children.cbegin(), children.cend(),
+		[ parentHead ] ( Key child )
 		{
-			continue;
+			auto const childRect = GetWidgetRect( child );
+			return childRect.y + childRect.h < parentHead;
 		}
-		if( childHead_below_parentFoot )
+	);
+	auto const last = std::partition_point( first, children.cend(),
+		[ parentFoot ] ( Key child )
 		{
-			break;
+			return GetWidgetRect( child ).y <= parentFoot;
 		}
+	);
+	return VisibleChildren
+	{
+		.first = static_cast<size_t>( first - children.cbegin() ),
+		.last = static_cast<size_t>( last - children.cbegin() )
+	};
+}
 
-		// child is visible
-		visibleChildren.push_back( child );
-	}
+// clamped, as children may have changed since the layout
+static std::span<Key const> visibleChildren( Key self )
+{
+	auto const& visible = GetState<VisibleChildren>( self );
+	auto const& children = GetChildWidgets( self );
+	auto const last = std::min( visible.last, children.size() );
+	auto const first = std::min( visible.first, last );
+	return std::span<Key const>{ children }.subspan( first, last - first );
+}
 
-	SetState<VisibleChildren>( self,
-		[=] ( VisibleChildren& vc )
+// render the children overlapping content rows 'strip', in order
+static void renderStrip( Key self, Rect r, int scrollY, Render::ContentRows strip )
+{
+	// children are stacked top to bottom: skip to the first reaching into the strip
+	// (inclusively, as bottom edges may be drawn)
+	auto const& children = GetChildWidgets( self );
+	auto first = std::partition_point( children.cbegin(), children.cend(),
+		[ strip ] ( Key child )
 		{
-			vc.children = visibleChildren;
+			auto const childRect = GetWidgetRect( child );
+			return childRect.y + childRect.h < strip.top;
 		}
 	);
+
+	Render::BeginScrollStrip( self, r, scrollY, strip );
+	for( auto it = first; it != children.cend() && GetWidgetRect( *it ).y < strip.bottom; ++it )
+	{
+		RenderLayoutTree( *it, 0, r.y - scrollY );
+	}
+	Render::EndScrollStrip();
 }
 
 Key VScrollBox(
@@ -62,8 +90,9 @@ Key VScrollBox(
 			CreateState<WidgetState>( self );
 
 			// VScrollBox state
-			CreateState<VisibleChildren>( self );
+			CreateState<OnBuildLayout>( self );
 			CreateState<Transform>( self, Transform{ .y = initialVScroll }, true );
+			CreateComputedState<VisibleChildren>( self, calcVisibleChildren );
 			ObserveState<Transform>( self, self,
 				[] ( Key self, Transform const& transform )
 				{
@@ -76,11 +105,11 @@ Key VScrollBox(
 					}
 
 					// clamp transform.y at the bottom
-					auto const& visibleChildren = GetState<VisibleChildren>( self ).children;
-					if( visibleChildren.size() )
+					auto const visible = visibleChildren( self );
+					if( visible.size() )
 					{
 						auto lastChild = GetChildWidgets( self ).back();
-						if( contains( visibleChildren, lastChild ) )
+						if( visible.back() == lastChild )
 						{
 							// Console::Print( "\nLast child is visible." );
 							// last child is visible, so check it's LayoutRect
@@ -101,15 +130,6 @@ Key VScrollBox(
 							}
 						}
 					}
-					
-					calcVisibleChildren( self, transform );
-				}
-			);
-			CreateState<OnBuildLayout>( self );
-			ObserveState<OnBuildLayout>( self, self,
-				[] ( Key self, OnBuildLayout const& )
-				{
-					calcVisibleChildren( self, GetState<Transform>( self ) );
 				}
 			);
 		},
@@ -124,17 +144,32 @@ Key VScrollBox(
 		// renderWidget
 		[] ( Key self, Rect r ) -> bool
 		{
-			auto const& visibleChildren = GetState<VisibleChildren>( self );
+			auto const visible = visibleChildren( self );
 			auto const& transform = GetState<Transform>( self );
-			Render::SetClipRect( r );
+
+			// scroll by blitting a cached band of content, drawing only the rows
+			// newly scrolled into it or invalidated
+			std::span<Render::ContentRows const> strips;
+			if( Render::ScrollLayer( self, r, transform.y, strips ) )
+			{
+				for( auto const strip : strips )
+				{
+					renderStrip( self, r, transform.y, strip );
+				}
+				Render::DrawScrollLayer( self, r, transform.y );
+				return false;
+			}
+
+			// no layer, so draw directly
+			Render::PushClipRect( r );
 			// Render::DrawRect( r, White );
 
 			// render children myself
-			for( auto const child : visibleChildren.children )
+			for( auto const child : visible )
 			{
 				RenderLayoutTree( child, 0, r.y - transform.y );
 			}
-			Render::ResetClipRect();
+			Render::PopClipRect();
 			return false;
 		},
 
@@ -152,7 +187,7 @@ Key VScrollBox(
 				hitTree.push_back( self );
 				auto numHits = hitTree.size();
 				auto const& transform = GetState<Transform>( self );
-				for( auto const child : GetState<VisibleChildren>( self ).children )
+				for( auto const child : visibleChildren( self ) )
 				{
 					RunHitTests( child, x + transform.x - r.x, y + transform.y - r.y, hitTree );
 					if( hitTree.size() != numHits )
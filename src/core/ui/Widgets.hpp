@@ -16,6 +16,9 @@ Key AppRoot( int w, int h, Key Main );
 
 Key Text( WidthRequest width, HeightRequest height, std::string const& text, Font font );
 
+// change what a Text widget says
+void SetText( Key textWidget, std::string text );
+
 Key RoundedBox( WidthRequest width, HeightRequest height, RoundedBoxFormat format, HitTestMethod hitTest, Key child );
 
 Key AlignLeft( WidthRequest width, HeightRequest height, Key child );
@@ -28,42 +31,48 @@ Key Column( WidthRequest width, HeightRequest height, std::initializer_list<Key>
 
 Key Padding( WidthRequest wr, HeightRequest hr, int left, int right, int top, int bottom, Key child );
 
+// caches what 'child' draws in an offscreen layer, drawn again only when a state or
+// layout within it changes. Children must draw nothing but their states and layouts.
+Key RepaintBoundary( Key child );
+
+// rolling engine counters and frame times (see core/Counters.hpp)
+Key PerfHud( int width, int height, RoundedBoxFormat format );
+
+// show the latest figures; call once a frame
+void UpdatePerfHud( Key hud );
 
-using KeyFinder = std::function< Key( Key self ) >;
+
+// small, as Hiding keeps both in its computed state
+using KeyFinder = InplaceFunction< Key( Key self ), 16 >;
 
 template<typename TriggeringState>
-using VisibilityTest = std::function< bool( Key self, TriggeringState const& triggeringState ) >;
+using VisibilityTest = InplaceFunction< bool( Key self, TriggeringState const& triggeringState ), 16 >;
 
+// shows 'child' while 'visibilityTest' passes for the triggering widget's state
 template<typename TriggeringState>
-Key Hiding( bool initialVisibility, KeyFinder getTriggeringKey, VisibilityTest<TriggeringState> visibilityTest, Key child )
+Key Hiding( KeyFinder getTriggeringKey, VisibilityTest<TriggeringState> visibilityTest, Key child )
 {
 	return CreateWidget( "",
 
 		// initState
-		[ initialVisibility, getTriggeringKey, visibilityTest ] ( Key self )
+		[ getTriggeringKey, visibilityTest ] ( Key self )
 		{
-			CreateState<WidgetState>( self, WidgetState{ .isVisible = initialVisibility } );
-			ObserveState<TriggeringState>( self, getTriggeringKey( self ),
-				[ visibilityTest ] ( Key self, TriggeringState const& triggeringState )
+			CreateState<WidgetState>( self );
+
+			// recomputed whenever the triggering state changes
+			auto const triggeringKey = getTriggeringKey( self );
+			CreateComputedState<Visibility>( self,
+				[ triggeringKey, visibilityTest ] ( Key self )
+				{
+					return Visibility{ .isVisible = visibilityTest( self, GetState<TriggeringState>( triggeringKey ) ) };
+				}
+			);
+
+			// but only relaid out when the result changes
+			ObserveState<Visibility>( self, self,
+				[] ( Key, Visibility const& )
 				{
-          // the triggering state has changed. Determine if
-          // I should be visible
-					auto iShouldBeVisible = visibilityTest( self, triggeringState );
-
-					// early exit: no need to change
-					if( GetState<WidgetState>( self ).isVisible == iShouldBeVisible )
-					{
-						return;
-					}
-
-					// schedule the change
-					SetState<WidgetState>( self,
-						[=] ( WidgetState& selfState )
-						{
-							selfState.isVisible = iShouldBeVisible;
-							SetRebuildLayoutTree();
-						}
-					);
+					SetRebuildLayoutTree();
 				}
 			);
 		},
@@ -71,8 +80,7 @@ Key Hiding( bool initialVisibility, KeyFinder getTriggeringKey, VisibilityTest<T
 		// buildLayout
 		[] ( Key self )
 		{
-			auto const& widgetState = GetState<WidgetState>( self );
-			if( widgetState.isVisible )
+			if( GetState<Visibility>( self ).isVisible )
 			{
 				return Box( AutoWidth, AutoHeight );
 			}
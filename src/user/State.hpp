@@ -3,6 +3,9 @@
 #ifndef USER_STATE_HPP_INCLUDED
 #define USER_STATE_HPP_INCLUDED
 
+#include "core/Key.hpp"
+
+#include<string>
 #include<string_view>
 
 struct ChatEntry
@@ -11,12 +14,17 @@ struct ChatEntry
   std::string speech;
 };
 
-// using AppDatabase = Database<
+// User states need no registration: declare them here (or in any header)
+// and use them with CreateState<>() etc.
 
-//   // States used by core (DO NOT EDIT)
-//   WidgetState, TextState, Transform, VisibleChildren
+// the Text widgets of a ChatBubbles, to rebind it to another entry
+struct ChatBubblesTexts
+{
+  static constexpr auto AsString = "ChatBubblesTexts";
+  Key speech = NullKey;
+  Key author = NullKey;
 
-//   // User: add yours here:
-// >;
+  bool operator==( ChatBubblesTexts const& ) const = default;
+};
 
 #endif
\ No newline at end of file
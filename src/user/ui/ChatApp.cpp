@@ -3,8 +3,11 @@
 #include "core/ui/Widgets.hpp"
 #include "user/ui/Widgets.hpp"
 
+#include<algorithm>
 #include<array>
 #include<map>
+#include<string>
+#include<vector>
 
 static const std::array s_ChatMessages =
 {
@@ -27,8 +30,62 @@ static const std::map<std::string_view, rgba32> s_ChatColours =
 	{ "Jane", rgba32{ 145, 39, 143, 255 } }
 };
 
-Key ChatApp()
+Key ChatMessage( ChatEntry const& message )
 {
+	auto chatBubbles = ChatBubbles(
+		WidthAtLeast( 0.5f ), AutoHeight,
+		s_ChatColours.at( message.author ),
+		message
+	);
+	return Padding( AutoWidth, AutoHeight, 5, 5, 5, 5,
+
+		// child
+		message.author == "Jane"
+		?	AlignLeft(
+				AutoWidth, AutoHeight,
+				chatBubbles		
+			)
+		: AlignRight(
+				AutoWidth, AutoHeight,
+				chatBubbles
+			)
+	);
+}
+
+void SetChatMessage( Key chatMessage, ChatEntry const& message )
+{
+	// Padding, then Align, then ChatBubbles beside a spacer
+	auto const& aligned = GetChildWidgets( GetChildWidgets( chatMessage ).front() );
+	auto const chatBubbles = std::ranges::find_if( aligned, [] ( Key child ) { return HasState<ChatBubblesTexts>( child ); } );
+	SetChatEntry( *chatBubbles, message );
+}
+
+ChildDescriptor ChatMessageChild( std::string key, ChatEntry const& message )
+{
+	return ChildDescriptor
+	{
+		.key = std::move( key ),
+		.create = [ &message ] ()
+		{
+			return ChatMessage( message );
+		},
+		.update = [ &message ] ( Key self )
+		{
+			SetChatMessage( self, message );
+		},
+
+		// the author decides the colour and side
+		.signature = "ChatMessage/" + message.author
+	};
+}
+
+Key ChatApp( int numMessages )
+{
+	if( numMessages <= 0 )
+	{
+		numMessages = static_cast<int>( s_ChatMessages.size() );
+	}
+
   return Column( AutoWidth, AutoHeight,
 	{
 		RoundedBox( AutoWidth, AutoHeight, RoundedBoxFormat{ .colour = Blue, .radius = 10 }, DefaultHitTest, Text( AutoWidth, AutoHeight, "Hello", Font{} ) ),
@@ -47,34 +104,16 @@ Key ChatApp()
 				// add above chat entries after default initState has been run
 				Custom
 				{
-					.extraInitState = [] ( Key self )
+					.extraInitState = [ numMessages ] ( Key self )
 					{
-						// for( auto i = 0; i < 1; ++i )
-						for( auto const& message : s_ChatMessages )
+						// the conversation, looped to 'numMessages', keyed by position
+						std::vector<ChildDescriptor> messages;
+						messages.reserve( numMessages );
+						for( auto i = 0; i < numMessages; ++i )
 						{
-							// auto const& message = s_ChatMessages.at( i );
-							auto chatBubbles = ChatBubbles(
-								WidthAtLeast( 0.5f ), AutoHeight,
-								s_ChatColours.at( message.author ),
-								message
-							);
-							CreateChildWidget(
-								self,
-								Padding( AutoWidth, AutoHeight, 5, 5, 5, 5,
-
-									// child
-									message.author == "Jane"
-									?	AlignLeft(
-											AutoWidth, AutoHeight,
-											chatBubbles		
-										)
-									: AlignRight(
-											AutoWidth, AutoHeight,
-											chatBubbles
-										)
-								)
-							);
+							messages.push_back( ChatMessageChild( std::to_string( i ), s_ChatMessages.at( i % s_ChatMessages.size() ) ) );
 						}
+						SetChildren( self, messages );
 					}
 				},
 
@@ -4,14 +4,27 @@
 
 #include<format>
 
+static constexpr Font s_Font
+{
+	.face = "Roboto",
+	.colour = rgba32{ 255, 255, 255, 255 },
+	.pointSize = 12,
+	.isBold = false,
+	.isItalic = false
+};
+
 Key ChatBubbles( WidthRequest width, HeightRequest height, rgba32 colour, ChatEntry const& chatEntry )
 {
+	auto const speech = Text( AutoWidth, AutoHeight, chatEntry.speech, s_Font );
+	auto const author = Text( AutoWidth, AutoHeight, chatEntry.author, s_Font );
+
   return CreateWidget( "",
 
 		// initState
-		[] ( Key self )
+		[ speech, author ] ( Key self )
 		{
 			CreateState<WidgetState>( self );
+			CreateState<ChatBubblesTexts>( self, ChatBubblesTexts{ .speech = speech, .author = author } );
 		},
 
 		// buildLayout
@@ -36,39 +49,30 @@ Key ChatBubbles( WidthRequest width, HeightRequest height, rgba32 colour, ChatEn
 			// Padding( AutoWidth, AutoHeight, 5, 5, 10, 10, 
 
 				// child
-				RoundedBox(
-					AutoWidth, AutoHeight,
-					RoundedBoxFormat
-					{
-						.colour = colour,
-						.radius = 10
-					},
-					DefaultHitTest,
+				// drawn once, then blitted until hovered
+				RepaintBoundary(
 
 					// child
-					Padding( AutoWidth, AutoHeight, 5, 5, 5, 5,
+					RoundedBox(
+						AutoWidth, AutoHeight,
+						RoundedBoxFormat
+						{
+							.colour = colour,
+							.radius = 10
+						},
+						DefaultHitTest,
 
 						// child
-						Text(
-							AutoWidth, AutoHeight,
-							chatEntry.speech,
-							Font
-							{
-								.face = "Roboto",
-								.colour = rgba32{ 255, 255, 255, 255 },
-								.pointSize = 12,
-								.isBold = false,
-								.isItalic = false
-							}
+						Padding( AutoWidth, AutoHeight, 5, 5, 5, 5,
+
+							// child
+							speech
 						)
 					)
 				// )
 			),
 			Hiding<WidgetState>(
 
-				// initialVisibility
-				false,
-
 				// getTriggeringKey
 				[] ( Key self ) -> Key
 				{
@@ -98,22 +102,18 @@ Key ChatBubbles( WidthRequest width, HeightRequest height, rgba32 colour, ChatEn
 						Padding( AutoWidth, AutoHeight, 5, 5, 5, 5,
 
 							// child
-							Text(
-								AutoWidth, AutoHeight,
-								chatEntry.author,
-								Font
-								{
-									.face = "Roboto",
-									.colour = rgba32{ 255, 255, 255, 255 },
-									.pointSize = 12,
-									.isBold = false,
-									.isItalic = false
-								}
-							)
+							author
 						)
 					)
 				)
 			)
 		}
 	);
-}
\ No newline at end of file
+}
+
+void SetChatEntry( Key chatBubbles, ChatEntry const& chatEntry )
+{
+	auto const& texts = GetState<ChatBubblesTexts>( chatBubbles );
+	SetText( texts.speech, chatEntry.speech );
+	SetText( texts.author, chatEntry.author );
+}
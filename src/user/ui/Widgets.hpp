@@ -7,8 +7,22 @@
 
 using namespace Layouts;
 
-Key ChatApp();
+// the conversation, looped to 'numMessages' (by default, played once)
+Key ChatApp( int numMessages = 0 );
 
 Key ChatBubbles( WidthRequest wr, HeightRequest hr, rgba32 colour, ChatEntry const& chatEntry );
 
+// show another entry, e.g. when recycled; the colour stays
+void SetChatEntry( Key chatBubbles, ChatEntry const& chatEntry );
+
+// an entry's ChatBubbles, padded and aligned to its author's side
+Key ChatMessage( ChatEntry const& message );
+
+// show another entry by the same author
+void SetChatMessage( Key chatMessage, ChatEntry const& message );
+
+// a ChatMessage for SetChildren(), recycled between entries by the same author.
+// 'message' must outlive the call to SetChildren().
+ChildDescriptor ChatMessageChild( std::string key, ChatEntry const& message );
+
 #endif
\ No newline at end of file